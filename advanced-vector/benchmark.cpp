@@ -0,0 +1,546 @@
+#include "flat_map.h"
+#include "pool_allocator.h"
+#include "vector.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <memory>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// Сравнение Vector и std::vector. Результаты выводятся в stdout в формате CSV:
+// container,scenario,element,element_size,ns_per_op,allocs_per_op
+// Операция — один вставленный, удаленный или скопированный элемент. Учитываются выделения
+// памяти самим контейнером, но не элементами.
+// Для каждого замера берется лучший из REPETITIONS запусков.
+// Сценарий churn_mt сравнивает аллокаторы: CHURN_THREADS потоков одновременно создают и
+// уничтожают небольшие векторы, операция — один созданный вектор.
+// Сценарии lookup_N сравнивают поиск в таблице из N ключей int в std::map и FlatMap,
+// операция — один поиск существующего или отсутствующего ключа.
+//
+// Сборка: g++ -std=c++17 -O2 -DNDEBUG -pthread benchmark.cpp -o benchmark
+
+namespace
+{
+    const int REPETITIONS = 5;
+    const size_t GROWTH_COUNT = 100'000;
+    const size_t BASE_SIZE = 10'000;
+    const size_t MIDDLE_OPS = 1'000;
+    const size_t CHURN_THREADS = 4;
+    const size_t CHURN_VECTORS = 200'000;
+    const size_t CHURN_MAX_SIZE = 64;
+    const size_t LOOKUP_OPS = 1'000'000;
+
+    // Счетчик потока, чтобы замеры в нескольких потоках не мешали друг другу
+    thread_local size_t num_allocations = 0;
+
+    // Аллокатор, подсчитывающий выделения памяти контейнером. Память выделяет Upstream
+    template <typename T, typename Upstream = std::allocator<T>>
+    struct CountingAllocator
+    {
+        using value_type = T;
+
+        template <typename U>
+        struct rebind
+        {
+            using other = CountingAllocator<U, typename std::allocator_traits<Upstream>::template rebind_alloc<U>>;
+        };
+
+        CountingAllocator() = default;
+
+        template <typename U, typename OtherUpstream>
+        CountingAllocator(const CountingAllocator<U, OtherUpstream> & /*other*/) noexcept
+        {
+        }
+
+        T *allocate(size_t n)
+        {
+            ++num_allocations;
+            return Upstream().allocate(n);
+        }
+
+        void deallocate(T *p, size_t n) noexcept
+        {
+            Upstream().deallocate(p, n);
+        }
+
+        // Расширение на месте и перенос блока передаются Upstream, если он их поддерживает,
+        // чтобы вектор с CountingAllocator выбирал те же пути роста, что и без него
+        template <typename U = Upstream, typename = std::enable_if_t<detail::HasTryExpand<U>::value>>
+        bool try_expand(T *p, size_t old_n, size_t new_n) noexcept
+        {
+            return U().try_expand(p, old_n, new_n);
+        }
+
+        template <typename U = Upstream, typename = std::enable_if_t<detail::HasReallocate<U>::value>>
+        T *reallocate(T *p, size_t old_n, size_t new_n)
+        {
+            ++num_allocations;
+            return U().reallocate(p, old_n, new_n);
+        }
+
+        template <typename U, typename OtherUpstream>
+        bool operator==(const CountingAllocator<U, OtherUpstream> & /*other*/) const noexcept
+        {
+            return true;
+        }
+
+        template <typename U, typename OtherUpstream>
+        bool operator!=(const CountingAllocator<U, OtherUpstream> & /*other*/) const noexcept
+        {
+            return false;
+        }
+    };
+
+    // Тривиально копируемый элемент
+    template <size_t SIZE>
+    struct Pod
+    {
+        static std::string Name()
+        {
+            return "pod";
+        }
+
+        Pod() = default;
+
+        explicit Pod(size_t seed) noexcept
+        {
+            std::memset(bytes, static_cast<int>(seed), SIZE);
+        }
+
+        unsigned char bytes[SIZE];
+    };
+
+    // Элемент, владеющий данными в куче: перемещение дешевое и не выбрасывает исключений,
+    // копирование выделяет память
+    template <size_t SIZE>
+    struct MoveHeavy
+    {
+        // Размер элемента не зависит от SIZE, поэтому размер данных в куче указываем в имени
+        static std::string Name()
+        {
+            return "move_heavy" + std::to_string(SIZE);
+        }
+
+        MoveHeavy()
+            : data(std::make_unique<unsigned char[]>(SIZE)) //
+        {
+        }
+
+        explicit MoveHeavy(size_t seed)
+            : MoveHeavy() //
+        {
+            std::memset(data.get(), static_cast<int>(seed), SIZE);
+        }
+
+        MoveHeavy(const MoveHeavy &other)
+            : MoveHeavy() //
+        {
+            std::memcpy(data.get(), other.data.get(), SIZE);
+        }
+
+        MoveHeavy(MoveHeavy &&other) noexcept = default;
+
+        MoveHeavy &operator=(const MoveHeavy &other)
+        {
+            if (!data)
+            {
+                data = std::make_unique<unsigned char[]>(SIZE);
+            }
+            std::memcpy(data.get(), other.data.get(), SIZE);
+            return *this;
+        }
+
+        MoveHeavy &operator=(MoveHeavy &&other) noexcept = default;
+
+        std::unique_ptr<unsigned char[]> data;
+    };
+
+    // Элемент без конструктора перемещения: при росте контейнер вынужден копировать
+    template <size_t SIZE>
+    struct CopyOnly
+    {
+        static std::string Name()
+        {
+            return "copy_only";
+        }
+
+        CopyOnly() = default;
+
+        explicit CopyOnly(size_t seed) noexcept
+        {
+            std::memset(bytes, static_cast<int>(seed), SIZE);
+        }
+
+        CopyOnly(const CopyOnly &other)
+        {
+            std::memcpy(bytes, other.bytes, SIZE);
+        }
+
+        CopyOnly &operator=(const CopyOnly &other)
+        {
+            std::memcpy(bytes, other.bytes, SIZE);
+            return *this;
+        }
+
+        unsigned char bytes[SIZE] = {};
+    };
+
+    // Единый интерфейс к сравниваемым контейнерам
+    template <typename T>
+    struct StdVectorOps
+    {
+        using Container = std::vector<T, CountingAllocator<T>>;
+        using Value = T;
+
+        static const char *Name()
+        {
+            return "std::vector";
+        }
+
+        static void PushBack(Container &c, const T &value)
+        {
+            c.push_back(value);
+        }
+
+        static void Reserve(Container &c, size_t n)
+        {
+            c.reserve(n);
+        }
+
+        static void Insert(Container &c, size_t offset, const T &value)
+        {
+            c.insert(c.begin() + offset, value);
+        }
+
+        static void Erase(Container &c, size_t offset)
+        {
+            c.erase(c.begin() + offset);
+        }
+
+        static size_t Size(const Container &c)
+        {
+            return c.size();
+        }
+    };
+
+    template <typename T>
+    struct VectorOps
+    {
+        using Container = Vector<T, CountingAllocator<T>>;
+        using Value = T;
+
+        static const char *Name()
+        {
+            return "Vector";
+        }
+
+        static void PushBack(Container &c, const T &value)
+        {
+            c.PushBack(value);
+        }
+
+        static void Reserve(Container &c, size_t n)
+        {
+            c.Reserve(n);
+        }
+
+        static void Insert(Container &c, size_t offset, const T &value)
+        {
+            c.Insert(c.cbegin() + offset, value);
+        }
+
+        static void Erase(Container &c, size_t offset)
+        {
+            c.Erase(c.cbegin() + offset);
+        }
+
+        static size_t Size(const Container &c)
+        {
+            return c.Size();
+        }
+    };
+
+    struct Measurement
+    {
+        double ns_per_op = std::numeric_limits<double>::infinity();
+        double allocs_per_op = 0;
+    };
+
+    // Не дает компилятору выбросить результаты замеров
+    volatile size_t sink = 0;
+
+    // prepare готовит состояние вне замера, run выполняет замеряемую работу и возвращает
+    // число операций. Возвращает лучший из REPETITIONS запусков
+    template <typename Prepare, typename Run>
+    Measurement Measure(Prepare prepare, Run run)
+    {
+        using Clock = std::chrono::steady_clock;
+        Measurement best;
+        for (int i = 0; i < REPETITIONS; ++i)
+        {
+            auto state = prepare();
+            const size_t allocations_before = num_allocations;
+            const Clock::time_point start = Clock::now();
+            const size_t ops = run(state);
+            const Clock::time_point finish = Clock::now();
+            const size_t allocations = num_allocations - allocations_before;
+
+            const double ns_per_op = std::chrono::duration<double, std::nano>(finish - start).count() / ops;
+            if (ns_per_op < best.ns_per_op)
+            {
+                best = {ns_per_op, static_cast<double>(allocations) / ops};
+            }
+        }
+        return best;
+    }
+
+    template <typename Ops>
+    typename Ops::Container MakeFilled(size_t size)
+    {
+        typename Ops::Container c;
+        Ops::Reserve(c, size);
+        for (size_t i = 0; i < size; ++i)
+        {
+            Ops::PushBack(c, typename Ops::Value(i));
+        }
+        return c;
+    }
+
+    void Report(const char *container, const char *scenario, const std::string &element, size_t element_size,
+                const Measurement &m)
+    {
+        std::cout << container << ',' << scenario << ',' << element << ',' << element_size << ','
+                  << m.ns_per_op << ',' << m.allocs_per_op << '\n';
+    }
+
+    template <template <typename> typename OpsTemplate, typename T>
+    void RunScenarios()
+    {
+        using Ops = OpsTemplate<T>;
+        using Container = typename Ops::Container;
+        const std::string element = T::Name();
+        const auto report = [&element](const char *scenario, const Measurement &m)
+        {
+            Report(Ops::Name(), scenario, element, sizeof(T), m);
+        };
+
+        report("push_back", Measure([]
+                                    { return T(1); },
+                                    [](const T &value)
+                                    {
+                                        Container c;
+                                        for (size_t i = 0; i < GROWTH_COUNT; ++i)
+                                        {
+                                            Ops::PushBack(c, value);
+                                        }
+                                        sink = sink + Ops::Size(c);
+                                        return GROWTH_COUNT;
+                                    }));
+
+        report("reserve_fill", Measure([]
+                                       { return T(1); },
+                                       [](const T &value)
+                                       {
+                                           Container c;
+                                           Ops::Reserve(c, GROWTH_COUNT);
+                                           for (size_t i = 0; i < GROWTH_COUNT; ++i)
+                                           {
+                                               Ops::PushBack(c, value);
+                                           }
+                                           sink = sink + Ops::Size(c);
+                                           return GROWTH_COUNT;
+                                       }));
+
+        report("insert_middle", Measure([]
+                                        {
+                                            Container c = MakeFilled<Ops>(BASE_SIZE);
+                                            Ops::Reserve(c, BASE_SIZE + MIDDLE_OPS);
+                                            return std::make_pair(std::move(c), T(1));
+                                        },
+                                        [](std::pair<Container, T> &state)
+                                        {
+                                            for (size_t i = 0; i < MIDDLE_OPS; ++i)
+                                            {
+                                                Ops::Insert(state.first, Ops::Size(state.first) / 2, state.second);
+                                            }
+                                            sink = sink + Ops::Size(state.first);
+                                            return MIDDLE_OPS;
+                                        }));
+
+        report("erase_middle", Measure([]
+                                       { return MakeFilled<Ops>(BASE_SIZE + MIDDLE_OPS); },
+                                       [](Container &c)
+                                       {
+                                           for (size_t i = 0; i < MIDDLE_OPS; ++i)
+                                           {
+                                               Ops::Erase(c, Ops::Size(c) / 2);
+                                           }
+                                           sink = sink + Ops::Size(c);
+                                           return MIDDLE_OPS;
+                                       }));
+
+        report("copy_assign_fit", Measure([]
+                                          { return std::make_pair(MakeFilled<Ops>(BASE_SIZE), MakeFilled<Ops>(BASE_SIZE)); },
+                                          [](std::pair<Container, Container> &state)
+                                          {
+                                              state.second = state.first;
+                                              sink = sink + Ops::Size(state.second);
+                                              return BASE_SIZE;
+                                          }));
+
+        report("copy_assign_grow", Measure([]
+                                           { return std::make_pair(MakeFilled<Ops>(BASE_SIZE), Container()); },
+                                           [](std::pair<Container, Container> &state)
+                                           {
+                                               state.second = state.first;
+                                               sink = sink + Ops::Size(state.second);
+                                               return BASE_SIZE;
+                                           }));
+    }
+
+    // Каждый поток создает CHURN_VECTORS векторов от 1 до CHURN_MAX_SIZE элементов.
+    // Выделения памяти всех потоков добавляются к счетчику вызывающего потока
+    template <typename Container, typename T>
+    size_t RunChurn()
+    {
+        std::atomic<size_t> allocations{0};
+        std::vector<std::thread> workers;
+        for (size_t t = 0; t < CHURN_THREADS; ++t)
+        {
+            workers.emplace_back([&allocations, t]
+                                 {
+                                     size_t total = 0;
+                                     for (size_t i = 0; i < CHURN_VECTORS; ++i)
+                                     {
+                                         Container c;
+                                         const size_t size = (i * 7 + t) % CHURN_MAX_SIZE + 1;
+                                         for (size_t j = 0; j < size; ++j)
+                                         {
+                                             c.PushBack(T(j));
+                                         }
+                                         total += c.Size();
+                                     }
+                                     sink = sink + total;
+                                     allocations += num_allocations;
+                                 });
+        }
+        for (std::thread &worker : workers)
+        {
+            worker.join();
+        }
+        num_allocations += allocations;
+        return CHURN_THREADS * CHURN_VECTORS;
+    }
+
+    template <typename T>
+    void CompareChurn()
+    {
+        using GlobalVector = Vector<T, CountingAllocator<T>>;
+        using PooledVector = Vector<T, CountingAllocator<T, PoolAllocator<T>>, PoolGrowth>;
+        // С удвоением емкость не совпадает с классом размеров, и вектор растет внутри
+        // класса через try_expand
+        using ExpandingVector = Vector<T, CountingAllocator<T, PoolAllocator<T>>>;
+        static_assert(detail::HasTryExpand<CountingAllocator<T, PoolAllocator<T>>>::value,
+                      "CountingAllocator must forward try_expand");
+        const auto prepare = []
+        { return 0; };
+        Report("Vector", "churn_mt", T::Name(), sizeof(T), Measure(prepare, [](int)
+                                                                   { return RunChurn<GlobalVector, T>(); }));
+        Report("Vector+PoolAllocator", "churn_mt", T::Name(), sizeof(T), Measure(prepare, [](int)
+                                                                                 { return RunChurn<PooledVector, T>(); }));
+        Report("Vector+PoolAllocator+try_expand", "churn_mt", T::Name(), sizeof(T), Measure(prepare, [](int)
+                                                                                            { return RunChurn<ExpandingVector, T>(); }));
+    }
+
+    // Ищет LOOKUP_OPS псевдослучайных ключей, половина из которых есть в таблице.
+    // find(map, key) возвращает признак наличия ключа
+    template <typename Map, typename Find>
+    size_t RunLookup(const Map &map, size_t size, Find find)
+    {
+        size_t found = 0;
+        uint64_t state = 88172645463325252ULL;
+        for (size_t i = 0; i < LOOKUP_OPS; ++i)
+        {
+            // xorshift64: ключи не повторяются короткими циклами и не угадываются предсказателем
+            state ^= state << 13;
+            state ^= state >> 7;
+            state ^= state << 17;
+            found += find(map, static_cast<int>(state % (size * 2))) ? 1 : 0;
+        }
+        sink = sink + found;
+        return LOOKUP_OPS;
+    }
+
+    // Ключи таблицы — четные числа от 0 до 2 * size
+    template <typename Search>
+    FlatMap<int, int, std::less<int>, Search> MakeFlatTable(size_t size)
+    {
+        std::vector<std::pair<int, int>> pairs;
+        for (size_t i = 0; i < size; ++i)
+        {
+            pairs.emplace_back(static_cast<int>(i * 2), static_cast<int>(i));
+        }
+        FlatMap<int, int, std::less<int>, Search> map;
+        map.BulkInsert(pairs);
+        return map;
+    }
+
+    void CompareLookup(size_t size)
+    {
+        const std::string scenario = "lookup_" + std::to_string(size);
+        std::map<int, int> tree;
+        for (size_t i = 0; i < size; ++i)
+        {
+            tree.emplace(static_cast<int>(i * 2), static_cast<int>(i));
+        }
+        const auto flat = MakeFlatTable<BranchlessSearch>(size);
+        const auto eytzinger = MakeFlatTable<EytzingerSearch>(size);
+        const auto prepare = []
+        { return 0; };
+        Report("std::map", scenario.c_str(), "int", sizeof(int), Measure(prepare, [&](int)
+                                                                          { return RunLookup(tree, size, [](const std::map<int, int> &map, int key)
+                                                                                             { return map.find(key) != map.end(); }); }));
+        Report("FlatMap", scenario.c_str(), "int", sizeof(int), Measure(prepare, [&](int)
+                                                                         { return RunLookup(flat, size, [](const auto &map, int key)
+                                                                                            { return map.Find(key) != nullptr; }); }));
+        Report("FlatMap+Eytzinger", scenario.c_str(), "int", sizeof(int), Measure(prepare, [&](int)
+                                                                                   { return RunLookup(eytzinger, size, [](const auto &map, int key)
+                                                                                                      { return map.Find(key) != nullptr; }); }));
+    }
+
+    template <typename T>
+    void Compare()
+    {
+        RunScenarios<StdVectorOps, T>();
+        RunScenarios<VectorOps, T>();
+    }
+
+    template <template <size_t> typename Element>
+    void CompareSizes()
+    {
+        Compare<Element<4>>();
+        Compare<Element<16>>();
+        Compare<Element<64>>();
+        Compare<Element<256>>();
+    }
+
+} // namespace
+
+int main()
+{
+    std::cout << "container,scenario,element,element_size,ns_per_op,allocs_per_op\n";
+    CompareSizes<Pod>();
+    CompareSizes<MoveHeavy>();
+    CompareSizes<CopyOnly>();
+    CompareChurn<Pod<4>>();
+    CompareChurn<Pod<16>>();
+    CompareLookup(1'000);
+    CompareLookup(1'000'000);
+}
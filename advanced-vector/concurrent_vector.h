@@ -0,0 +1,277 @@
+#pragma once
+#include "vector.h"
+
+#include <limits>
+#include <stdexcept>
+
+namespace concurrent_detail
+{
+    // Номер старшего установленного бита, value > 0
+    inline size_t FloorLog2(size_t value) noexcept
+    {
+#if defined(__GNUC__)
+        return std::numeric_limits<unsigned long long>::digits - 1 - __builtin_clzll(value);
+#else
+        size_t result = 0;
+        while (value >>= 1)
+        {
+            ++result;
+        }
+        return result;
+#endif
+    }
+} // namespace concurrent_detail
+
+// Вектор только для добавления, в который могут одновременно писать несколько потоков.
+// Элементы хранятся в сегментах емкости FIRST_SEGMENT, 2 * FIRST_SEGMENT, 4 * FIRST_SEGMENT...
+// Сегменты не перемещаются, поэтому ссылки на элементы остаются действительными до
+// уничтожения вектора, а читатели обращаются к элементам без блокировок.
+// EmplaceBack резервирует позицию атомарной операцией, создает элемент на месте и отмечает
+// его флагом готовности. Производители не ждут друг друга: Size() — длина самого длинного
+// префикса готовых элементов, поэтому элементы [0, Size()) всегда доступны для чтения из
+// любого потока, а медленный производитель задерживает только рост Size().
+// Аллокатор должен допускать одновременные вызовы из разных потоков
+template <typename T, typename Alloc = std::allocator<T>, size_t FIRST_SEGMENT = 32>
+class ConcurrentVector
+{
+    static_assert(FIRST_SEGMENT > 0 && (FIRST_SEGMENT & (FIRST_SEGMENT - 1)) == 0,
+                  "FIRST_SEGMENT must be a power of two");
+
+    using AllocTraits = std::allocator_traits<Alloc>;
+    using FlagAlloc = typename AllocTraits::template rebind_alloc<std::atomic<bool>>;
+    using FlagAllocTraits = std::allocator_traits<FlagAlloc>;
+
+public:
+    using allocator_type = Alloc;
+
+    ConcurrentVector() = default;
+
+    explicit ConcurrentVector(const Alloc &alloc) noexcept
+        : alloc_(alloc)
+    {
+    }
+
+    ConcurrentVector(const ConcurrentVector &) = delete;
+    ConcurrentVector &operator=(const ConcurrentVector &) = delete;
+
+    ~ConcurrentVector()
+    {
+        const size_t size = Size();
+        for (size_t i = 0; i < size; ++i)
+        {
+            std::destroy_at(&(*this)[i]);
+        }
+        FlagAlloc flag_alloc(alloc_);
+        for (size_t segment = 0; segment < MAX_SEGMENTS; ++segment)
+        {
+            if (T *data = segments_[segment].load(std::memory_order_relaxed))
+            {
+                AllocTraits::deallocate(alloc_, data, SegmentCapacity(segment));
+            }
+            if (std::atomic<bool> *flags = ready_[segment].load(std::memory_order_relaxed))
+            {
+                FlagAllocTraits::deallocate(flag_alloc, flags, SegmentCapacity(segment));
+            }
+        }
+    }
+
+    // Количество опубликованных элементов: все элементы до этой позиции созданы
+    size_t Size() const noexcept
+    {
+        return published_.load(std::memory_order_acquire);
+    }
+
+    // Заранее выделяет сегменты под capacity элементов. Можно вызывать одновременно с EmplaceBack
+    void Reserve(size_t capacity)
+    {
+        if (capacity == 0)
+        {
+            return;
+        }
+        const size_t last_segment = Locate(capacity - 1).segment;
+        for (size_t segment = 0; segment <= last_segment; ++segment)
+        {
+            EnsureSegment(segment);
+        }
+    }
+
+    // Добавляет элемент и возвращает ссылку на него. Элемент может еще не входить в [0, Size()),
+    // если раньше зарезервированные позиции заполняются другими потоками. Если конструктор выбросит исключение,
+    // вектор не изменится. Для типов, конструктор которых может выбросить исключение,
+    // элемент сначала создается во временном объекте и затем перемещается на место
+    template <typename... Args>
+    T &EmplaceBack(Args &&...args)
+    {
+        if constexpr (std::is_nothrow_constructible_v<T, Args...>)
+        {
+            const size_t index = ReserveIndex();
+            T *slot = new (Slot(index)) T(std::forward<Args>(args)...);
+            Publish(index);
+            return *slot;
+        }
+        else
+        {
+            static_assert(std::is_nothrow_move_constructible_v<T>,
+                          "ConcurrentVector requires nothrow move constructible T");
+            T value(std::forward<Args>(args)...);
+            const size_t index = ReserveIndex();
+            T *slot = new (Slot(index)) T(std::move(value));
+            Publish(index);
+            return *slot;
+        }
+    }
+
+    T &PushBack(const T &value)
+    {
+        return EmplaceBack(value);
+    }
+
+    T &PushBack(T &&value)
+    {
+        return EmplaceBack(std::move(value));
+    }
+
+    const T &operator[](size_t index) const noexcept
+    {
+        return const_cast<ConcurrentVector &>(*this)[index];
+    }
+
+    T &operator[](size_t index) noexcept
+    {
+        assert(index < Size());
+        const Location location = Locate(index);
+        return segments_[location.segment].load(std::memory_order_acquire)[location.offset];
+    }
+
+private:
+    static constexpr size_t FIRST_SEGMENT_LOG2 = []
+    {
+        size_t result = 0;
+        while ((size_t(1) << result) != FIRST_SEGMENT)
+        {
+            ++result;
+        }
+        return result;
+    }();
+    static constexpr size_t MAX_SEGMENTS = std::numeric_limits<size_t>::digits - FIRST_SEGMENT_LOG2;
+
+    struct Location
+    {
+        size_t segment;
+        size_t offset;
+    };
+
+    // Сегмент k начинается с индекса FIRST_SEGMENT * (2^k - 1), поэтому номер сегмента
+    // определяется старшим битом index + FIRST_SEGMENT
+    static Location Locate(size_t index) noexcept
+    {
+        const size_t shifted = index + FIRST_SEGMENT;
+        const size_t high_bit = concurrent_detail::FloorLog2(shifted);
+        return {high_bit - FIRST_SEGMENT_LOG2, shifted - (size_t(1) << high_bit)};
+    }
+
+    static size_t SegmentCapacity(size_t segment) noexcept
+    {
+        return FIRST_SEGMENT << segment;
+    }
+
+    // Выделяет сегмент, если его еще нет. Из нескольких потоков, одновременно выделивших
+    // один и тот же сегмент, свой сохраняет только один, остальные освобождают память
+    T *EnsureSegment(size_t segment)
+    {
+        EnsureFlags(segment);
+        T *data = segments_[segment].load(std::memory_order_acquire);
+        if (data != nullptr)
+        {
+            return data;
+        }
+        T *fresh = AllocTraits::allocate(alloc_, SegmentCapacity(segment));
+        if (segments_[segment].compare_exchange_strong(data, fresh, std::memory_order_acq_rel,
+                                                       std::memory_order_acquire))
+        {
+            return fresh;
+        }
+        AllocTraits::deallocate(alloc_, fresh, SegmentCapacity(segment));
+        return data;
+    }
+
+    // Флаги готовности элементов сегмента выделяются так же, как сам сегмент
+    std::atomic<bool> *EnsureFlags(size_t segment)
+    {
+        std::atomic<bool> *flags = ready_[segment].load(std::memory_order_acquire);
+        if (flags != nullptr)
+        {
+            return flags;
+        }
+        FlagAlloc flag_alloc(alloc_);
+        std::atomic<bool> *fresh = FlagAllocTraits::allocate(flag_alloc, SegmentCapacity(segment));
+        for (size_t i = 0; i < SegmentCapacity(segment); ++i)
+        {
+            new (fresh + i) std::atomic<bool>(false);
+        }
+        if (ready_[segment].compare_exchange_strong(flags, fresh, std::memory_order_acq_rel,
+                                                    std::memory_order_acquire))
+        {
+            return fresh;
+        }
+        FlagAllocTraits::deallocate(flag_alloc, fresh, SegmentCapacity(segment));
+        return flags;
+    }
+
+    // Резервирует следующую позицию. Сегмент под нее выделяется до резервирования, поэтому
+    // при нехватке памяти вектор остается неизменным
+    size_t ReserveIndex()
+    {
+        size_t index = reserved_.load(std::memory_order_relaxed);
+        for (;;)
+        {
+            if (index == std::numeric_limits<size_t>::max() - FIRST_SEGMENT)
+            {
+                throw std::length_error("ConcurrentVector is too long");
+            }
+            EnsureSegment(Locate(index).segment);
+            if (reserved_.compare_exchange_weak(index, index + 1))
+            {
+                return index;
+            }
+        }
+    }
+
+    void *Slot(size_t index) noexcept
+    {
+        const Location location = Locate(index);
+        return segments_[location.segment].load(std::memory_order_acquire) + location.offset;
+    }
+
+    std::atomic<bool> &ReadyFlag(size_t index) noexcept
+    {
+        const Location location = Locate(index);
+        return ready_[location.segment].load(std::memory_order_acquire)[location.offset];
+    }
+
+    // Отмечает элемент index готовым и продвигает published_ по готовым элементам. Между
+    // резервированием позиции и публикацией не выполняется ничего, что может выбросить
+    // исключение, поэтому в префиксе не остается позиций, которые никогда не станут готовыми.
+    // Флаг и published_ читаются и пишутся последовательно согласованно: из двух потоков,
+    // отметивших соседние элементы, хотя бы один увидит флаг другого и продвинет published_
+    void Publish(size_t index) noexcept
+    {
+        ReadyFlag(index).store(true);
+        size_t published = published_.load();
+        while (published < reserved_.load() && ReadyFlag(published).load())
+        {
+            // При неудаче published получает новое значение, продвинутое другим потоком
+            if (published_.compare_exchange_weak(published, published + 1))
+            {
+                ++published;
+            }
+        }
+    }
+
+    Alloc alloc_;
+    std::atomic<T *> segments_[MAX_SEGMENTS] = {};
+    std::atomic<std::atomic<bool> *> ready_[MAX_SEGMENTS] = {};
+    // Счетчики изменяются всеми производителями, поэтому разнесены по разным кэш-линиям
+    alignas(64) std::atomic<size_t> reserved_{0};
+    alignas(64) std::atomic<size_t> published_{0};
+};
\ No newline at end of file
@@ -0,0 +1,369 @@
+#pragma once
+#include "vector.h"
+
+namespace cow_detail
+{
+    // Счетчик ссылок разделяемого объекта. Объект, на который есть только одна ссылка,
+    // принадлежит одному владельцу и может изменяться без копирования
+    class RefCounted
+    {
+    public:
+        void AddRef() noexcept
+        {
+            refs_.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        // Возвращает true, если это была последняя ссылка
+        bool RemoveRef() noexcept
+        {
+            return refs_.fetch_sub(1, std::memory_order_acq_rel) == 1;
+        }
+
+        // Изменения, сделанные другими владельцами до отказа от ссылки, видны после true
+        bool IsUnique() const noexcept
+        {
+            return refs_.load(std::memory_order_acquire) == 1;
+        }
+
+    private:
+        std::atomic<size_t> refs_{1};
+    };
+
+    // Блок элементов. Элементы [0, size) созданы
+    template <typename T, typename Alloc>
+    struct Chunk : RefCounted
+    {
+        Chunk(size_t capacity, const Alloc &alloc)
+            : data(capacity, alloc)
+        {
+        }
+
+        ~Chunk()
+        {
+            std::destroy_n(data.GetAddress(), size);
+        }
+
+        RawMemory<T, Alloc> data;
+        size_t size = 0;
+    };
+
+    template <typename Object>
+    void Unref(Object *object) noexcept
+    {
+        if (object != nullptr && object->RemoveRef())
+        {
+            delete object;
+        }
+    }
+
+    // Таблица блоков владеет по одной ссылке на каждый блок
+    template <typename Chunk>
+    struct Table : RefCounted
+    {
+        ~Table()
+        {
+            for (Chunk *chunk : chunks)
+            {
+                Unref(chunk);
+            }
+        }
+
+        Vector<Chunk *> chunks;
+    };
+} // namespace cow_detail
+
+// Вектор с копированием при записи. Копия CowVector выполняется за O(1): копии разделяют
+// таблицу блоков и сами блоки по CHUNK_SIZE элементов, подсчитывая ссылки атомарно.
+// Запись затрагивает только свой блок: при первом изменении копируются таблица указателей
+// на блоки и один блок, а не весь вектор.
+// Разные объекты CowVector, разделяющие данные, можно читать и изменять из разных потоков.
+// Один объект, как и Vector, не потокобезопасен.
+// Чтение — const operator[]. Ссылка, возвращенная Mutable, действительна до копирования
+// вектора: после него запись через нее изменила бы и копию
+template <typename T, typename Alloc = std::allocator<T>, size_t CHUNK_SIZE = 1024>
+class CowVector
+{
+    static_assert(CHUNK_SIZE > 0, "CHUNK_SIZE must be positive");
+
+    using Chunk = cow_detail::Chunk<T, Alloc>;
+    using Table = cow_detail::Table<Chunk>;
+
+public:
+    using allocator_type = Alloc;
+
+    class const_iterator
+    {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const T *;
+        using reference = const T &;
+
+        const_iterator(const CowVector *owner, size_t index) noexcept
+            : owner_(owner), index_(index)
+        {
+        }
+
+        const T &operator*() const noexcept
+        {
+            return (*owner_)[index_];
+        }
+        const T *operator->() const noexcept
+        {
+            return &(*owner_)[index_];
+        }
+        const_iterator &operator++() noexcept
+        {
+            ++index_;
+            return *this;
+        }
+        const_iterator operator++(int) noexcept
+        {
+            const_iterator old = *this;
+            ++index_;
+            return old;
+        }
+        bool operator==(const const_iterator &other) const noexcept
+        {
+            return index_ == other.index_;
+        }
+        bool operator!=(const const_iterator &other) const noexcept
+        {
+            return index_ != other.index_;
+        }
+
+    private:
+        const CowVector *owner_;
+        size_t index_;
+    };
+
+    CowVector() = default;
+
+    explicit CowVector(const Alloc &alloc) noexcept
+        : alloc_(alloc)
+    {
+    }
+
+    // Снимок за O(1): данные разделяются до первой записи. Каждый блок хранит аллокатор,
+    // которым выделен, поэтому новые блоки копии могут выделяться другим аллокатором
+    CowVector(const CowVector &other) noexcept
+        : alloc_(std::allocator_traits<Alloc>::select_on_container_copy_construction(other.alloc_)),
+          table_(other.table_), size_(other.size_)
+    {
+        if (table_ != nullptr)
+        {
+            table_->AddRef();
+        }
+    }
+
+    CowVector(CowVector &&other) noexcept
+        : alloc_(other.alloc_), table_(std::exchange(other.table_, nullptr)), size_(std::exchange(other.size_, 0))
+    {
+    }
+
+    ~CowVector()
+    {
+        Clear();
+    }
+
+    CowVector &operator=(const CowVector &rhs) noexcept
+    {
+        if (this != &rhs)
+        {
+            CowVector(rhs).Swap(*this);
+        }
+        return *this;
+    }
+
+    CowVector &operator=(CowVector &&rhs) noexcept
+    {
+        if (this != &rhs)
+        {
+            Clear();
+            Swap(rhs);
+        }
+        return *this;
+    }
+
+    void Swap(CowVector &other) noexcept
+    {
+        using std::swap;
+        swap(alloc_, other.alloc_);
+        std::swap(table_, other.table_);
+        std::swap(size_, other.size_);
+    }
+
+    const Alloc &GetAllocator() const noexcept
+    {
+        return alloc_;
+    }
+
+    size_t Size() const noexcept
+    {
+        return size_;
+    }
+
+    // Данные вектора разделяются с другими копиями
+    bool IsShared() const noexcept
+    {
+        return table_ != nullptr && !table_->IsUnique();
+    }
+
+    void Clear() noexcept
+    {
+        cow_detail::Unref(std::exchange(table_, nullptr));
+        size_ = 0;
+    }
+
+    const T &operator[](size_t index) const noexcept
+    {
+        assert(index < size_);
+        return table_->chunks[index / CHUNK_SIZE]->data[index % CHUNK_SIZE];
+    }
+
+    // Возвращает изменяемую ссылку на элемент, предварительно скопировав его блок,
+    // если тот разделяется с другими копиями
+    T &Mutable(size_t index)
+    {
+        assert(index < size_);
+        return UniqueChunk(index / CHUNK_SIZE)->data[index % CHUNK_SIZE];
+    }
+
+    void PushBack(const T &value)
+    {
+        EmplaceBack(value);
+    }
+    void PushBack(T &&value)
+    {
+        EmplaceBack(std::move(value));
+    }
+
+    // Добавляет элемент в конец, копируя при необходимости только последний блок.
+    // Если конструктор выбросит исключение, содержимое вектора не изменится
+    template <typename... Args>
+    T &EmplaceBack(Args &&...args)
+    {
+        const size_t offset = size_ % CHUNK_SIZE;
+        if (offset != 0)
+        {
+            Chunk *chunk = UniqueChunk(size_ / CHUNK_SIZE);
+            T *slot = new (chunk->data + offset) T(std::forward<Args>(args)...);
+            ++chunk->size;
+            ++size_;
+            return *slot;
+        }
+
+        // Следующий блок
+        Table *table = UniqueTable();
+        table->chunks.Reserve(table->chunks.Size() + 1);
+        Chunk *chunk = new Chunk(CHUNK_SIZE, alloc_);
+        T *slot = nullptr;
+        try
+        {
+            slot = new (chunk->data.GetAddress()) T(std::forward<Args>(args)...);
+        }
+        catch (...)
+        {
+            delete chunk;
+            throw;
+        }
+        chunk->size = 1;
+        table->chunks.PushBack(chunk);
+        ++size_;
+        return *slot;
+    }
+
+    void PopBack()
+    {
+        assert(size_ > 0);
+        const size_t chunk_index = (size_ - 1) / CHUNK_SIZE;
+        if ((size_ - 1) % CHUNK_SIZE == 0)
+        {
+            // Блок становится пустым: достаточно отказаться от ссылки на него
+            Table *table = UniqueTable();
+            cow_detail::Unref(table->chunks[chunk_index]);
+            table->chunks.PopBack();
+        }
+        else
+        {
+            Chunk *chunk = UniqueChunk(chunk_index);
+            std::destroy_at(chunk->data + chunk->size - 1);
+            --chunk->size;
+        }
+        --size_;
+    }
+
+    const_iterator begin() const noexcept
+    {
+        return {this, 0};
+    }
+    const_iterator end() const noexcept
+    {
+        return {this, size_};
+    }
+    const_iterator cbegin() const noexcept
+    {
+        return begin();
+    }
+    const_iterator cend() const noexcept
+    {
+        return end();
+    }
+
+private:
+    // Делает таблицу блоков собственной, копируя ее при разделении
+    Table *UniqueTable()
+    {
+        if (table_ == nullptr)
+        {
+            table_ = new Table();
+        }
+        else if (!table_->IsUnique())
+        {
+            Table *copy = new Table();
+            try
+            {
+                copy->chunks = table_->chunks;
+            }
+            catch (...)
+            {
+                delete copy;
+                throw;
+            }
+            for (Chunk *chunk : copy->chunks)
+            {
+                chunk->AddRef();
+            }
+            cow_detail::Unref(std::exchange(table_, copy));
+        }
+        return table_;
+    }
+
+    // Делает блок index собственным, копируя при разделении таблицу и сам блок
+    Chunk *UniqueChunk(size_t index)
+    {
+        Table *table = UniqueTable();
+        Chunk *&chunk = table->chunks[index];
+        if (!chunk->IsUnique())
+        {
+            Chunk *copy = new Chunk(CHUNK_SIZE, alloc_);
+            try
+            {
+                std::uninitialized_copy_n(chunk->data.GetAddress(), chunk->size, copy->data.GetAddress());
+            }
+            catch (...)
+            {
+                delete copy;
+                throw;
+            }
+            copy->size = chunk->size;
+            cow_detail::Unref(std::exchange(chunk, copy));
+        }
+        return chunk;
+    }
+
+    Alloc alloc_;
+    Table *table_ = nullptr;
+    size_t size_ = 0;
+};
\ No newline at end of file
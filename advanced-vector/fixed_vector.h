@@ -0,0 +1,253 @@
+#pragma once
+#include "vector.h"
+
+#include <initializer_list>
+#include <stdexcept>
+
+namespace fixed_detail
+{
+    // Хранилище тривиальных элементов — обычный массив. Все N ячеек инициализируются нулями,
+    // поэтому FixedVector тривиальных типов можно строить в constexpr уже в C++17, а его копия
+    // и деструктор остаются тривиальными
+    template <typename T, size_t N, bool = std::is_trivial_v<T>>
+    struct Storage
+    {
+        template <typename... Args>
+        constexpr void Construct(size_t index, Args &&...args)
+        {
+            elements[index] = T(std::forward<Args>(args)...);
+        }
+
+        constexpr void Destroy(size_t /*first*/, size_t /*last*/) noexcept
+        {
+        }
+
+        T elements[N] = {};
+        size_t size = 0;
+    };
+
+    // Нетривиальные элементы создаются в неактивном члене объединения. В constexpr-вычислениях
+    // доступно начиная с C++20
+    template <typename T, size_t N>
+    struct Storage<T, N, false>
+    {
+        VECTOR_CONSTEXPR Storage() noexcept
+        {
+        }
+
+        // Делегирование гарантирует вызов деструктора, если конструктор элемента выбросит исключение
+        VECTOR_CONSTEXPR Storage(const Storage &other)
+            : Storage()
+        {
+            for (; size < other.size; ++size)
+            {
+                detail::ConstructAt(elements + size, other.elements[size]);
+            }
+        }
+
+        VECTOR_CONSTEXPR Storage(Storage &&other) noexcept(std::is_nothrow_move_constructible_v<T>)
+            : Storage()
+        {
+            for (; size < other.size; ++size)
+            {
+                detail::ConstructAt(elements + size, std::move(other.elements[size]));
+            }
+        }
+
+        VECTOR_CONSTEXPR Storage &operator=(const Storage &rhs)
+        {
+            if (this != &rhs)
+            {
+                const size_t common = std::min(size, rhs.size);
+                std::copy_n(rhs.elements, common, elements);
+                Destroy(rhs.size, size);
+                for (; size < rhs.size; ++size)
+                {
+                    detail::ConstructAt(elements + size, rhs.elements[size]);
+                }
+                size = rhs.size;
+            }
+            return *this;
+        }
+
+        VECTOR_CONSTEXPR Storage &operator=(Storage &&rhs) noexcept(std::is_nothrow_move_assignable_v<T> &&
+                                                                    std::is_nothrow_move_constructible_v<T>)
+        {
+            if (this != &rhs)
+            {
+                const size_t common = std::min(size, rhs.size);
+                std::move(rhs.elements, rhs.elements + common, elements);
+                Destroy(rhs.size, size);
+                for (; size < rhs.size; ++size)
+                {
+                    detail::ConstructAt(elements + size, std::move(rhs.elements[size]));
+                }
+                size = rhs.size;
+            }
+            return *this;
+        }
+
+        VECTOR_CONSTEXPR ~Storage()
+        {
+            std::destroy_n(elements, size);
+        }
+
+        template <typename... Args>
+        VECTOR_CONSTEXPR void Construct(size_t index, Args &&...args)
+        {
+            detail::ConstructAt(elements + index, std::forward<Args>(args)...);
+        }
+
+        // Уничтожает элементы [first, last), если first < last
+        VECTOR_CONSTEXPR void Destroy(size_t first, size_t last) noexcept
+        {
+            for (size_t i = first; i < last; ++i)
+            {
+                std::destroy_at(elements + i);
+            }
+        }
+
+        union
+        {
+            T elements[N];
+        };
+        size_t size = 0;
+    };
+} // namespace fixed_detail
+
+// Вектор емкости N со встроенным хранилищем, который никогда не выделяет память и не растет.
+// Подходит для таблиц, вычисляемых на этапе компиляции: constexpr-объект FixedVector
+// размещается в секции данных программы и не строится при запуске. Для тривиальных T
+// это работает и в C++17, для остальных — начиная с C++20.
+// Вставка сверх емкости выбрасывает std::length_error, а в constexpr-вычислении приводит
+// к ошибке компиляции
+template <typename T, size_t N>
+class FixedVector
+{
+    static_assert(N > 0, "FixedVector requires non-zero capacity");
+
+public:
+    static constexpr size_t CAPACITY = N;
+
+    using iterator = T *;
+    using const_iterator = const T *;
+
+    constexpr FixedVector() = default;
+
+    constexpr FixedVector(std::initializer_list<T> values)
+    {
+        CheckCapacity(values.size());
+        for (const T &value : values)
+        {
+            storage_.Construct(storage_.size++, value);
+        }
+    }
+
+    // Создает size элементов инициализацией значением
+    explicit constexpr FixedVector(size_t size)
+    {
+        Resize(size);
+    }
+
+    constexpr size_t Size() const noexcept
+    {
+        return storage_.size;
+    }
+
+    static constexpr size_t Capacity() noexcept
+    {
+        return N;
+    }
+
+    constexpr const T &operator[](size_t index) const noexcept
+    {
+        assert(index < storage_.size);
+        return storage_.elements[index];
+    }
+
+    constexpr T &operator[](size_t index) noexcept
+    {
+        assert(index < storage_.size);
+        return storage_.elements[index];
+    }
+
+    constexpr iterator begin() noexcept
+    {
+        return storage_.elements;
+    }
+    constexpr const_iterator begin() const noexcept
+    {
+        return storage_.elements;
+    }
+    constexpr const_iterator cbegin() const noexcept
+    {
+        return begin();
+    }
+    constexpr iterator end() noexcept
+    {
+        return storage_.elements + storage_.size;
+    }
+    constexpr const_iterator end() const noexcept
+    {
+        return storage_.elements + storage_.size;
+    }
+    constexpr const_iterator cend() const noexcept
+    {
+        return end();
+    }
+
+    template <typename... Args>
+    constexpr T &EmplaceBack(Args &&...args)
+    {
+        CheckCapacity(storage_.size + 1);
+        storage_.Construct(storage_.size, std::forward<Args>(args)...);
+        return storage_.elements[storage_.size++];
+    }
+
+    constexpr void PushBack(const T &value)
+    {
+        EmplaceBack(value);
+    }
+    constexpr void PushBack(T &&value)
+    {
+        EmplaceBack(std::move(value));
+    }
+
+    constexpr void PopBack() noexcept
+    {
+        assert(storage_.size > 0);
+        --storage_.size;
+        storage_.Destroy(storage_.size, storage_.size + 1);
+    }
+
+    constexpr void Resize(size_t new_size)
+    {
+        CheckCapacity(new_size);
+        if (new_size < storage_.size)
+        {
+            storage_.Destroy(new_size, storage_.size);
+            storage_.size = new_size;
+        }
+        for (; storage_.size < new_size; ++storage_.size)
+        {
+            storage_.Construct(storage_.size);
+        }
+    }
+
+    constexpr void Clear() noexcept
+    {
+        storage_.Destroy(0, storage_.size);
+        storage_.size = 0;
+    }
+
+private:
+    static constexpr void CheckCapacity(size_t size)
+    {
+        if (size > N)
+        {
+            throw std::length_error("FixedVector capacity exceeded");
+        }
+    }
+
+    fixed_detail::Storage<T, N> storage_;
+};
\ No newline at end of file
@@ -0,0 +1,654 @@
+#pragma once
+#include "vector.h"
+
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+
+namespace flat_detail
+{
+    // lower_bound без условных переходов: на каждом шаге половина диапазона отбрасывается
+    // условной пересылкой, поэтому время поиска не зависит от предсказания переходов
+    template <typename K, typename Compare>
+    size_t BranchlessLowerBound(const K *keys, size_t size, const K &key, const Compare &compare)
+    {
+        if (size == 0)
+        {
+            return 0;
+        }
+        const K *base = keys;
+        while (size > 1)
+        {
+            const size_t half = size / 2;
+            base += compare(base[half], key) ? half : 0;
+            size -= half;
+        }
+        return static_cast<size_t>(base - keys) + (compare(*base, key) ? 1 : 0);
+    }
+
+    // Количество младших единичных битов value
+    inline size_t TrailingOnes(size_t value) noexcept
+    {
+#if defined(__GNUC__)
+        return static_cast<size_t>(__builtin_ctzll(~static_cast<unsigned long long>(value)));
+#else
+        size_t count = 0;
+        for (; value & 1; value >>= 1)
+        {
+            ++count;
+        }
+        return count;
+#endif
+    }
+
+    // Номер старшего единичного бита value > 0
+    inline size_t Log2(size_t value) noexcept
+    {
+#if defined(__GNUC__)
+        return static_cast<size_t>(std::numeric_limits<unsigned long long>::digits - 1 -
+                                   __builtin_clzll(static_cast<unsigned long long>(value)));
+#else
+        size_t log = 0;
+        while (value >>= 1)
+        {
+            ++log;
+        }
+        return log;
+#endif
+    }
+} // namespace flat_detail
+
+// Политики поиска ключа во FlatSet и FlatMap. Index<K, Compare> хранится в контейнере:
+//     Rebuild(keys)                  — вызывается после каждого изменения отсортированных ключей;
+//     LowerBound(keys, key, compare) — номер первого ключа, не меньшего key;
+//     Find(keys, key, compare)       — номер ключа, равного key, или keys.Size().
+
+// Двоичный поиск без ветвлений по отсортированным ключам. Дополнительной памяти не требует
+struct BranchlessSearch
+{
+    template <typename K, typename Compare>
+    struct Index
+    {
+        void Rebuild(const Vector<K> & /*keys*/) noexcept
+        {
+        }
+
+        size_t LowerBound(const Vector<K> &keys, const K &key, const Compare &compare) const
+        {
+            return flat_detail::BranchlessLowerBound(keys.Data(), keys.Size(), key, compare);
+        }
+
+        size_t Find(const Vector<K> &keys, const K &key, const Compare &compare) const
+        {
+            const size_t index = LowerBound(keys, key, compare);
+            return index < keys.Size() && !compare(key, keys[index]) ? index : keys.Size();
+        }
+    };
+};
+
+// Поиск по копии ключей в порядке Эйтцингера — обходе дерева поиска в ширину. Верхние уровни
+// дерева лежат в начале массива и остаются в кэше, а следующий узел вычисляется без ветвлений.
+// Хранит копию ключей и перестраивается за O(n) при каждом изменении, поэтому подходит
+// для таблиц, которые заполняются через BulkInsert и затем в основном читаются.
+// Если перестроить индекс не удалось, поиск до следующего изменения идет двоичным поиском
+struct EytzingerSearch
+{
+    template <typename K, typename Compare>
+    class Index
+    {
+    public:
+        void Rebuild(const Vector<K> &keys)
+        {
+            layout_.Release();
+            Vector<K> layout;
+            layout.Reserve(keys.Size());
+            for (size_t k = 1; k <= keys.Size(); ++k)
+            {
+                layout.PushBack(keys[Rank(k, keys.Size())]);
+            }
+            layout_.Swap(layout);
+        }
+
+        size_t LowerBound(const Vector<K> &keys, const K &key, const Compare &compare) const
+        {
+            const size_t size = layout_.Size();
+            if (size != keys.Size() || size == 0)
+            {
+                return flat_detail::BranchlessLowerBound(keys.Data(), keys.Size(), key, compare);
+            }
+            const size_t k = Search(key, compare);
+            return k == 0 ? size : Rank(k, size);
+        }
+
+        // Ключ сравнивается с копией в узле, не обращаясь к отсортированному массиву
+        size_t Find(const Vector<K> &keys, const K &key, const Compare &compare) const
+        {
+            const size_t size = layout_.Size();
+            if (size != keys.Size() || size == 0)
+            {
+                const size_t index = flat_detail::BranchlessLowerBound(keys.Data(), keys.Size(), key, compare);
+                return index < keys.Size() && !compare(key, keys[index]) ? index : keys.Size();
+            }
+            const size_t k = Search(key, compare);
+            return k != 0 && !compare(key, layout_.Data()[k - 1]) ? Rank(k, size) : size;
+        }
+
+    private:
+        // Сколько уровней дерева помещается в одну кэш-линию из 64 байт
+        static constexpr size_t PREFETCH_LEVELS = sizeof(K) <= 4 ? 4 : sizeof(K) <= 8 ? 3 : sizeof(K) <= 16 ? 2 : 1;
+
+        // Узел первого ключа, не меньшего key, или 0, если все ключи меньше
+        size_t Search(const K &key, const Compare &compare) const
+        {
+            const size_t size = layout_.Size();
+            // Узлы нумеруются с 1: потомки узла k — 2k и 2k + 1, ключ узла k — layout[k - 1]
+            const K *const layout = layout_.Data();
+            size_t k = 1;
+            while (k <= size)
+            {
+#if defined(__GNUC__)
+                // Потомки узла на PREFETCH_LEVELS уровней ниже лежат подряд в одной кэш-линии:
+                // запрашиваем ее заранее. Адрес может выйти за конец массива, но предвыборка
+                // по такому адресу безвредна
+                __builtin_prefetch(reinterpret_cast<const void *>(
+                    reinterpret_cast<uintptr_t>(layout) + (k << PREFETCH_LEVELS) * sizeof(K)));
+#endif
+                k = 2 * k + (compare(layout[k - 1], key) ? 1 : 0);
+            }
+            // Отменяем переходы вправо после последнего перехода влево и сам этот переход
+            return k >> (flat_detail::TrailingOnes(k) + 1);
+        }
+
+        // Номер в отсортированном порядке ключа узла k дерева из size узлов, заполненного
+        // по уровням. Вычисляется без таблицы: сначала номер в полном дереве той же высоты,
+        // затем вычитаются недостающие узлы последнего уровня, которые в полном дереве
+        // занимают четные номера
+        static size_t Rank(size_t k, size_t size) noexcept
+        {
+            const size_t levels = flat_detail::Log2(size) + 1;
+            const size_t depth = flat_detail::Log2(k);
+            const size_t last_level = size - ((size_t(1) << (levels - 1)) - 1);
+            const size_t full_rank = ((2 * (k - (size_t(1) << depth)) + 1) << (levels - depth - 1)) - 1;
+            const size_t before = (full_rank + 1) / 2;
+            return full_rank - (before > last_level ? before - last_level : 0);
+        }
+
+        Vector<K> layout_;
+    };
+};
+
+// Множество на отсортированном Vector. Ключи лежат в одном непрерывном буфере: поиск читает
+// несколько соседних кэш-линий, а обход идет по памяти подряд. Вставка и удаление одного
+// ключа сдвигают хвост за O(n), поэтому наборы ключей выгоднее добавлять через BulkInsert.
+// Итераторы становятся недействительными после любого изменения
+template <typename K, typename Compare = std::less<K>, typename Search = BranchlessSearch>
+class FlatSet
+{
+    using Index = typename Search::template Index<K, Compare>;
+
+public:
+    using const_iterator = typename Vector<K>::const_iterator;
+    using iterator = const_iterator;
+
+    FlatSet() = default;
+
+    explicit FlatSet(const Compare &compare)
+        : compare_(compare)
+    {
+    }
+
+    FlatSet(std::initializer_list<K> keys, const Compare &compare = Compare())
+        : compare_(compare)
+    {
+        BulkInsert(keys.begin(), keys.end());
+    }
+
+    size_t Size() const noexcept
+    {
+        return keys_.Size();
+    }
+
+    void Reserve(size_t capacity)
+    {
+        keys_.Reserve(capacity);
+    }
+
+    void Clear()
+    {
+        keys_.Clear();
+        index_.Rebuild(keys_);
+    }
+
+    // Отсортированные ключи
+    Span<const K> Keys() const noexcept
+    {
+        return Span<const K>(keys_.Data(), keys_.Size());
+    }
+
+    const_iterator begin() const noexcept
+    {
+        return keys_.begin();
+    }
+    const_iterator end() const noexcept
+    {
+        return keys_.end();
+    }
+
+    // Первый ключ, не меньший key
+    const_iterator LowerBound(const K &key) const
+    {
+        return keys_.begin() + index_.LowerBound(keys_, key, compare_);
+    }
+
+    const_iterator Find(const K &key) const
+    {
+        return keys_.begin() + index_.Find(keys_, key, compare_);
+    }
+
+    bool Contains(const K &key) const
+    {
+        return Find(key) != end();
+    }
+
+    std::pair<const_iterator, bool> Insert(const K &key)
+    {
+        return InsertKey(key);
+    }
+    std::pair<const_iterator, bool> Insert(K &&key)
+    {
+        return InsertKey(std::move(key));
+    }
+
+    // Добавляет ключи диапазона [first, last), которых еще нет во множестве: ключи дописываются
+    // в конец, сортируются и сливаются с имеющимися за один проход.
+    // При исключении предоставляется базовая гарантия
+    template <typename InputIt, typename = detail::RequireInputIterator<InputIt>>
+    void BulkInsert(InputIt first, InputIt last)
+    {
+        const size_t old_size = keys_.Size();
+        keys_.Insert(keys_.end(), first, last);
+        const auto middle = keys_.begin() + old_size;
+        std::stable_sort(middle, keys_.end(), compare_);
+        std::inplace_merge(keys_.begin(), middle, keys_.end(), compare_);
+        const auto new_end = std::unique(keys_.begin(), keys_.end(),
+                                         [this](const K &lhs, const K &rhs)
+                                         { return !compare_(lhs, rhs); });
+        keys_.Erase(new_end, keys_.end());
+        index_.Rebuild(keys_);
+    }
+
+    template <typename Range>
+    void BulkInsert(const Range &range)
+    {
+        BulkInsert(std::begin(range), std::end(range));
+    }
+
+    size_t Erase(const K &key)
+    {
+        const const_iterator pos = Find(key);
+        if (pos == end())
+        {
+            return 0;
+        }
+        Erase(pos);
+        return 1;
+    }
+
+    const_iterator Erase(const_iterator pos)
+    {
+        const const_iterator next = keys_.Erase(pos);
+        index_.Rebuild(keys_);
+        return next;
+    }
+
+    // Удаляет ключи из полуинтервала [from, to). Возвращает количество удаленных ключей
+    size_t EraseRange(const K &from, const K &to)
+    {
+        const size_t first = index_.LowerBound(keys_, from, compare_);
+        const size_t last = std::max(first, index_.LowerBound(keys_, to, compare_));
+        keys_.Erase(keys_.begin() + first, keys_.begin() + last);
+        index_.Rebuild(keys_);
+        return last - first;
+    }
+
+private:
+    template <typename Key>
+    std::pair<const_iterator, bool> InsertKey(Key &&key)
+    {
+        const size_t index = index_.LowerBound(keys_, key, compare_);
+        if (index < keys_.Size() && !compare_(key, keys_[index]))
+        {
+            return {keys_.begin() + index, false};
+        }
+        keys_.Insert(keys_.begin() + index, std::forward<Key>(key));
+        index_.Rebuild(keys_);
+        return {keys_.begin() + index, true};
+    }
+
+    Vector<K> keys_;
+    Compare compare_;
+    Index index_;
+};
+
+// Ассоциативный массив на отсортированных Vector ключей и значений («структура массивов»):
+// поиск читает только буфер ключей, значения не занимают место в его кэш-линиях.
+// Разыменование итератора возвращает пару ссылок на ключ и значение, что позволяет писать
+//     for (auto [key, value] : map)
+// Вставка и удаление одного ключа сдвигают оба хвоста за O(n), наборы пар выгоднее
+// добавлять через BulkInsert. Итераторы и указатели на значения становятся
+// недействительными после любого изменения
+template <typename K, typename V, typename Compare = std::less<K>, typename Search = BranchlessSearch>
+class FlatMap
+{
+    using Index = typename Search::template Index<K, Compare>;
+
+    // Итератор по парам. Разыменование возвращает пару ссылок на ключ и значение
+    template <bool IS_CONST>
+    class PairIterator
+    {
+        using Owner = std::conditional_t<IS_CONST, const FlatMap, FlatMap>;
+
+    public:
+        using iterator_category = std::input_iterator_tag;
+        using value_type = std::pair<K, V>;
+        using reference = std::pair<const K &, std::conditional_t<IS_CONST, const V &, V &>>;
+        using pointer = void;
+        using difference_type = std::ptrdiff_t;
+
+        PairIterator(Owner *owner, size_t index) noexcept
+            : owner_(owner), index_(index)
+        {
+        }
+
+        reference operator*() const noexcept
+        {
+            return reference(owner_->keys_[index_], owner_->values_[index_]);
+        }
+
+        PairIterator &operator++() noexcept
+        {
+            ++index_;
+            return *this;
+        }
+
+        PairIterator operator++(int) noexcept
+        {
+            PairIterator old = *this;
+            ++index_;
+            return old;
+        }
+
+        bool operator==(const PairIterator &other) const noexcept
+        {
+            return owner_ == other.owner_ && index_ == other.index_;
+        }
+
+        bool operator!=(const PairIterator &other) const noexcept
+        {
+            return !(*this == other);
+        }
+
+    private:
+        Owner *owner_;
+        size_t index_;
+    };
+
+public:
+    using iterator = PairIterator<false>;
+    using const_iterator = PairIterator<true>;
+
+    FlatMap() = default;
+
+    explicit FlatMap(const Compare &compare)
+        : compare_(compare)
+    {
+    }
+
+    FlatMap(std::initializer_list<std::pair<K, V>> pairs, const Compare &compare = Compare())
+        : compare_(compare)
+    {
+        BulkInsert(pairs.begin(), pairs.end());
+    }
+
+    size_t Size() const noexcept
+    {
+        return keys_.Size();
+    }
+
+    void Reserve(size_t capacity)
+    {
+        keys_.Reserve(capacity);
+        values_.Reserve(capacity);
+    }
+
+    void Clear()
+    {
+        keys_.Clear();
+        values_.Clear();
+        index_.Rebuild(keys_);
+    }
+
+    // Отсортированные ключи и значения в том же порядке
+    Span<const K> Keys() const noexcept
+    {
+        return Span<const K>(keys_.Data(), keys_.Size());
+    }
+    Span<const V> Values() const noexcept
+    {
+        return Span<const V>(values_.Data(), values_.Size());
+    }
+    Span<V> Values() noexcept
+    {
+        return Span<V>(values_.Data(), values_.Size());
+    }
+
+    iterator begin() noexcept
+    {
+        return iterator(this, 0);
+    }
+    const_iterator begin() const noexcept
+    {
+        return const_iterator(this, 0);
+    }
+    iterator end() noexcept
+    {
+        return iterator(this, keys_.Size());
+    }
+    const_iterator end() const noexcept
+    {
+        return const_iterator(this, keys_.Size());
+    }
+
+    // Значение ключа key или nullptr, если ключа нет
+    V *Find(const K &key)
+    {
+        return const_cast<V *>(std::as_const(*this).Find(key));
+    }
+    const V *Find(const K &key) const
+    {
+        const size_t index = FindIndex(key);
+        return index < keys_.Size() ? values_.Data() + index : nullptr;
+    }
+
+    bool Contains(const K &key) const
+    {
+        return FindIndex(key) < keys_.Size();
+    }
+
+    // Выбрасывает std::out_of_range, если ключа нет
+    V &At(const K &key)
+    {
+        return const_cast<V &>(std::as_const(*this).At(key));
+    }
+    const V &At(const K &key) const
+    {
+        const V *value = Find(key);
+        if (value == nullptr)
+        {
+            throw std::out_of_range("FlatMap::At key not found");
+        }
+        return *value;
+    }
+
+    // Значение ключа key. Если ключа нет, он добавляется со значением V()
+    V &operator[](const K &key)
+    {
+        return *TryEmplace(key).first;
+    }
+
+    // Добавляет ключ со значением, созданным из args, если ключа еще нет.
+    // Возвращает указатель на значение ключа и признак вставки. Если конструктор значения
+    // выбросит исключение, контейнер не изменится
+    template <typename... Args>
+    std::pair<V *, bool> TryEmplace(const K &key, Args &&...args)
+    {
+        const size_t index = index_.LowerBound(keys_, key, compare_);
+        if (index < keys_.Size() && !compare_(key, keys_[index]))
+        {
+            return {values_.Data() + index, false};
+        }
+        keys_.Insert(keys_.begin() + index, key);
+        try
+        {
+            values_.Emplace(values_.begin() + index, std::forward<Args>(args)...);
+        }
+        catch (...)
+        {
+            keys_.Erase(keys_.begin() + index);
+            throw;
+        }
+        index_.Rebuild(keys_);
+        return {values_.Data() + index, true};
+    }
+
+    // Как TryEmplace, но значение имеющегося ключа заменяется присваиванием
+    template <typename M>
+    std::pair<V *, bool> InsertOrAssign(const K &key, M &&value)
+    {
+        const auto [current, inserted] = TryEmplace(key, std::forward<M>(value));
+        if (!inserted)
+        {
+            *current = std::forward<M>(value);
+        }
+        return {current, inserted};
+    }
+
+    // Добавляет пары (ключ, значение) диапазона [first, last) с ключами, которых еще нет
+    // в контейнере; из пар с одинаковым ключом добавляется первая. Пары собираются
+    // во временный вектор, сортируются и сливаются с имеющимися в новые буферы за один проход.
+    // Имеющиеся пары перемещаются, только если перемещение и ключа, и значения не выбрасывает
+    // исключений, иначе копируются, поэтому при исключении конструктора контейнер не изменится
+    template <typename InputIt, typename = detail::RequireInputIterator<InputIt>>
+    void BulkInsert(InputIt first, InputIt last)
+    {
+        Vector<std::pair<K, V>> added;
+        if constexpr (detail::IS_FORWARD_ITERATOR<InputIt>)
+        {
+            added.Reserve(static_cast<size_t>(std::distance(first, last)));
+        }
+        for (; first != last; ++first)
+        {
+            added.EmplaceBack((*first).first, (*first).second);
+        }
+        const auto compare_keys = [this](const std::pair<K, V> &lhs, const std::pair<K, V> &rhs)
+        {
+            return compare_(lhs.first, rhs.first);
+        };
+        std::stable_sort(added.begin(), added.end(), compare_keys);
+        added.Erase(std::unique(added.begin(), added.end(),
+                                [this](const std::pair<K, V> &lhs, const std::pair<K, V> &rhs)
+                                { return !compare_(lhs.first, rhs.first); }),
+                    added.end());
+        if (added.Size() == 0)
+        {
+            return;
+        }
+
+        Vector<K> keys;
+        Vector<V> values;
+        keys.Reserve(keys_.Size() + added.Size());
+        values.Reserve(keys_.Size() + added.Size());
+        constexpr bool MOVE_EXISTING =
+            (std::is_nothrow_move_constructible_v<K> && std::is_nothrow_move_constructible_v<V>) ||
+            !(std::is_copy_constructible_v<K> && std::is_copy_constructible_v<V>);
+        size_t i = 0;
+        size_t j = 0;
+        while (i < keys_.Size() || j < added.Size())
+        {
+            if (j == added.Size() || (i < keys_.Size() && !compare_(added[j].first, keys_[i])))
+            {
+                // Имеющийся ключ не больше добавляемого; равный добавляемый пропускаем
+                if (j < added.Size() && !compare_(keys_[i], added[j].first))
+                {
+                    ++j;
+                }
+                if constexpr (MOVE_EXISTING)
+                {
+                    keys.EmplaceBack(std::move(keys_[i]));
+                    values.EmplaceBack(std::move(values_[i]));
+                }
+                else
+                {
+                    keys.EmplaceBack(std::as_const(keys_[i]));
+                    values.EmplaceBack(std::as_const(values_[i]));
+                }
+                ++i;
+            }
+            else
+            {
+                keys.EmplaceBack(std::move(added[j].first));
+                values.EmplaceBack(std::move(added[j].second));
+                ++j;
+            }
+        }
+        keys_.Swap(keys);
+        values_.Swap(values);
+        index_.Rebuild(keys_);
+    }
+
+    template <typename Range>
+    void BulkInsert(const Range &range)
+    {
+        BulkInsert(std::begin(range), std::end(range));
+    }
+
+    size_t Erase(const K &key)
+    {
+        const size_t index = FindIndex(key);
+        if (index == keys_.Size())
+        {
+            return 0;
+        }
+        keys_.Erase(keys_.begin() + index);
+        values_.Erase(values_.begin() + index);
+        index_.Rebuild(keys_);
+        return 1;
+    }
+
+    // Удаляет ключи из полуинтервала [from, to) вместе со значениями.
+    // Возвращает количество удаленных пар
+    size_t EraseRange(const K &from, const K &to)
+    {
+        const size_t first = index_.LowerBound(keys_, from, compare_);
+        const size_t last = std::max(first, index_.LowerBound(keys_, to, compare_));
+        keys_.Erase(keys_.begin() + first, keys_.begin() + last);
+        values_.Erase(values_.begin() + first, values_.begin() + last);
+        index_.Rebuild(keys_);
+        return last - first;
+    }
+
+private:
+    // Номер ключа key или Size(), если ключа нет
+    size_t FindIndex(const K &key) const
+    {
+        return index_.Find(keys_, key, compare_);
+    }
+
+    Vector<K> keys_;
+    Vector<V> values_;
+    Compare compare_;
+    Index index_;
+};
\ No newline at end of file
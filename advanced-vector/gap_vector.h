@@ -0,0 +1,466 @@
+#pragma once
+#include "vector.h"
+
+// Вектор с промежутком (gap buffer) для редактирования последовательностей. Элементы хранятся
+// в одном буфере двумя частями: [0, Cursor()) в начале буфера и остальные в его конце, а между
+// ними находится промежуток свободной памяти. Вставка и удаление в позиции курсора выполняются
+// за O(1), перенос курсора на расстояние d — за O(d), поэтому серия вставок и удалений рядом
+// с одной позицией обходится без сдвига хвоста при каждой операции.
+// Вставка или удаление в другой позиции сначала переносит туда курсор. PushBack и PopBack
+// тоже переносят курсор в конец.
+// Перенос курсора не должен выбрасывать исключений: T должен быть тривиально перемещаемым
+// или иметь небросающий конструктор перемещения
+template <typename T, typename Alloc = std::allocator<T>, typename Growth = DoublingGrowth>
+class GapVector
+{
+    static_assert(IsTriviallyRelocatableV<T> || std::is_nothrow_move_constructible_v<T>,
+                  "GapVector requires trivially relocatable or nothrow move constructible T");
+
+    using Memory = RawMemory<T, Alloc>;
+
+public:
+    using allocator_type = Alloc;
+
+    template <bool IS_CONST>
+    class Iterator
+    {
+        using Owner = std::conditional_t<IS_CONST, const GapVector, GapVector>;
+
+    public:
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = std::conditional_t<IS_CONST, const T *, T *>;
+        using reference = std::conditional_t<IS_CONST, const T &, T &>;
+
+        Iterator() = default;
+
+        Iterator(Owner *owner, size_t index) noexcept
+            : owner_(owner), index_(index)
+        {
+        }
+
+        // Неконстантный итератор преобразуется в константный
+        template <bool OTHER_CONST, typename = std::enable_if_t<IS_CONST && !OTHER_CONST>>
+        Iterator(const Iterator<OTHER_CONST> &other) noexcept
+            : owner_(other.owner_), index_(other.index_)
+        {
+        }
+
+        reference operator*() const noexcept
+        {
+            return (*owner_)[index_];
+        }
+        pointer operator->() const noexcept
+        {
+            return &(*owner_)[index_];
+        }
+        reference operator[](difference_type n) const noexcept
+        {
+            return (*owner_)[index_ + n];
+        }
+
+        Iterator &operator++() noexcept
+        {
+            ++index_;
+            return *this;
+        }
+        Iterator operator++(int) noexcept
+        {
+            Iterator old = *this;
+            ++index_;
+            return old;
+        }
+        Iterator &operator--() noexcept
+        {
+            --index_;
+            return *this;
+        }
+        Iterator operator--(int) noexcept
+        {
+            Iterator old = *this;
+            --index_;
+            return old;
+        }
+        Iterator &operator+=(difference_type n) noexcept
+        {
+            index_ += n;
+            return *this;
+        }
+        Iterator &operator-=(difference_type n) noexcept
+        {
+            index_ -= n;
+            return *this;
+        }
+        friend Iterator operator+(Iterator it, difference_type n) noexcept
+        {
+            return it += n;
+        }
+        friend Iterator operator+(difference_type n, Iterator it) noexcept
+        {
+            return it += n;
+        }
+        friend Iterator operator-(Iterator it, difference_type n) noexcept
+        {
+            return it -= n;
+        }
+        friend difference_type operator-(const Iterator &lhs, const Iterator &rhs) noexcept
+        {
+            return static_cast<difference_type>(lhs.index_) - static_cast<difference_type>(rhs.index_);
+        }
+
+        friend bool operator==(const Iterator &lhs, const Iterator &rhs) noexcept
+        {
+            return lhs.index_ == rhs.index_;
+        }
+        friend bool operator!=(const Iterator &lhs, const Iterator &rhs) noexcept
+        {
+            return lhs.index_ != rhs.index_;
+        }
+        friend bool operator<(const Iterator &lhs, const Iterator &rhs) noexcept
+        {
+            return lhs.index_ < rhs.index_;
+        }
+        friend bool operator>(const Iterator &lhs, const Iterator &rhs) noexcept
+        {
+            return rhs < lhs;
+        }
+        friend bool operator<=(const Iterator &lhs, const Iterator &rhs) noexcept
+        {
+            return !(rhs < lhs);
+        }
+        friend bool operator>=(const Iterator &lhs, const Iterator &rhs) noexcept
+        {
+            return !(lhs < rhs);
+        }
+
+    private:
+        template <bool>
+        friend class Iterator;
+
+        Owner *owner_ = nullptr;
+        size_t index_ = 0;
+    };
+
+    using iterator = Iterator<false>;
+    using const_iterator = Iterator<true>;
+
+    GapVector() = default;
+
+    explicit GapVector(const Alloc &alloc) noexcept
+        : data_(alloc)
+    {
+    }
+
+    // Копия хранит элементы подряд, промежуток — в конце буфера
+    GapVector(const GapVector &other)
+        : data_(other.Size(), std::allocator_traits<Alloc>::select_on_container_copy_construction(other.GetAllocator()))
+    {
+        const Span<const T> before = other.BeforeCursor();
+        const Span<const T> after = other.AfterCursor();
+        std::uninitialized_copy(before.begin(), before.end(), data_.GetAddress());
+        try
+        {
+            std::uninitialized_copy(after.begin(), after.end(), data_ + before.Size());
+        }
+        catch (...)
+        {
+            std::destroy(data_.GetAddress(), data_ + before.Size());
+            throw;
+        }
+        gap_begin_ = gap_end_ = other.Size();
+    }
+
+    GapVector(GapVector &&other) noexcept
+        : data_(std::move(other.data_)),
+          gap_begin_(std::exchange(other.gap_begin_, 0)),
+          gap_end_(std::exchange(other.gap_end_, 0))
+    {
+    }
+
+    ~GapVector()
+    {
+        Clear();
+    }
+
+    GapVector &operator=(const GapVector &rhs)
+    {
+        if (this != &rhs)
+        {
+            GapVector(rhs).Swap(*this);
+        }
+        return *this;
+    }
+
+    GapVector &operator=(GapVector &&rhs) noexcept
+    {
+        if (this != &rhs)
+        {
+            Clear();
+            Swap(rhs);
+        }
+        return *this;
+    }
+
+    void Swap(GapVector &other) noexcept
+    {
+        data_.Swap(other.data_);
+        std::swap(gap_begin_, other.gap_begin_);
+        std::swap(gap_end_, other.gap_end_);
+    }
+
+    const Alloc &GetAllocator() const noexcept
+    {
+        return data_.GetAllocator();
+    }
+
+    size_t Size() const noexcept
+    {
+        return data_.Capacity() - (gap_end_ - gap_begin_);
+    }
+
+    size_t Capacity() const noexcept
+    {
+        return data_.Capacity();
+    }
+
+    // Позиция курсора: индекс первого элемента после промежутка
+    size_t Cursor() const noexcept
+    {
+        return gap_begin_;
+    }
+
+    // Переносит курсор в позицию pos, перемещая |pos - Cursor()| элементов
+    void MoveCursor(size_t pos) noexcept
+    {
+        assert(pos <= Size());
+        if (pos < gap_begin_)
+        {
+            const size_t count = gap_begin_ - pos;
+            Shift(data_ + pos, count, data_ + (gap_end_ - count));
+            gap_begin_ = pos;
+            gap_end_ -= count;
+        }
+        else if (pos > gap_begin_)
+        {
+            const size_t count = pos - gap_begin_;
+            Shift(data_ + gap_end_, count, data_ + gap_begin_);
+            gap_begin_ += count;
+            gap_end_ += count;
+        }
+    }
+
+    // Увеличивает емкость до new_capacity, сохраняя позицию курсора
+    void Reserve(size_t new_capacity)
+    {
+        if (new_capacity > Capacity())
+        {
+            Memory new_data(new_capacity, GetAllocator());
+            Relocate(new_data, gap_begin_);
+        }
+    }
+
+    void Clear() noexcept
+    {
+        std::destroy_n(data_.GetAddress(), gap_begin_);
+        std::destroy(data_ + gap_end_, data_ + Capacity());
+        gap_begin_ = 0;
+        gap_end_ = Capacity();
+    }
+
+    // Вставляет элемент в позицию pos и оставляет курсор после него, так что следующая
+    // вставка в pos + 1 не перемещает элементов. Аргументы могут ссылаться на элементы вектора.
+    // Если конструктор выбросит исключение, содержимое вектора не изменится
+    template <typename... Args>
+    T &Emplace(size_t pos, Args &&...args)
+    {
+        assert(pos <= Size());
+        if (gap_begin_ == gap_end_)
+        {
+            // Промежуток пуст, элементы лежат подряд. Старый буфер остается на месте до
+            // создания элемента, поэтому аргументы действительны
+            Memory new_data(Growth::NextCapacity(Capacity(), sizeof(T)), GetAllocator());
+            new (new_data + pos) T(std::forward<Args>(args)...);
+            // Пустой промежуток можно считать находящимся в любой позиции
+            gap_begin_ = gap_end_ = pos;
+            Relocate(new_data, pos, 1);
+        }
+        else
+        {
+            // Перенос курсора перемещает элементы, поэтому значение создается заранее
+            T value(std::forward<Args>(args)...);
+            MoveCursor(pos);
+            new (data_ + gap_begin_) T(std::move(value));
+            ++gap_begin_;
+        }
+        return data_[gap_begin_ - 1];
+    }
+
+    T &Insert(size_t pos, const T &value)
+    {
+        return Emplace(pos, value);
+    }
+    T &Insert(size_t pos, T &&value)
+    {
+        return Emplace(pos, std::move(value));
+    }
+
+    // Вставляет элементы [first, last) в позицию pos, курсор остается после них. Итераторы
+    // не должны указывать на элементы самого вектора. Если конструктор выбросит исключение,
+    // уже вставленные элементы остаются в векторе
+    template <typename InputIt, typename = detail::RequireInputIterator<InputIt>>
+    void InsertRange(size_t pos, InputIt first, InputIt last)
+    {
+        if constexpr (detail::IS_FORWARD_ITERATOR<InputIt>)
+        {
+            const size_t count = static_cast<size_t>(std::distance(first, last));
+            if (gap_end_ - gap_begin_ < count)
+            {
+                Reserve(std::max(Size() + count, Growth::NextCapacity(Capacity(), sizeof(T))));
+            }
+        }
+        MoveCursor(pos);
+        for (; first != last; ++first)
+        {
+            Emplace(gap_begin_, *first);
+        }
+    }
+
+    void PushBack(const T &value)
+    {
+        Emplace(Size(), value);
+    }
+    void PushBack(T &&value)
+    {
+        Emplace(Size(), std::move(value));
+    }
+
+    template <typename... Args>
+    T &EmplaceBack(Args &&...args)
+    {
+        return Emplace(Size(), std::forward<Args>(args)...);
+    }
+
+    // Удаляет элементы [first, last), курсор оказывается в позиции first
+    void Erase(size_t first, size_t last) noexcept
+    {
+        assert(first <= last && last <= Size());
+        MoveCursor(first);
+        std::destroy(data_ + gap_end_, data_ + (gap_end_ + last - first));
+        gap_end_ += last - first;
+    }
+
+    void Erase(size_t pos) noexcept
+    {
+        Erase(pos, pos + 1);
+    }
+
+    void PopBack() noexcept
+    {
+        assert(Size() > 0);
+        Erase(Size() - 1);
+    }
+
+    const T &operator[](size_t index) const noexcept
+    {
+        return const_cast<GapVector &>(*this)[index];
+    }
+
+    T &operator[](size_t index) noexcept
+    {
+        assert(index < Size());
+        return data_[index < gap_begin_ ? index : index + (gap_end_ - gap_begin_)];
+    }
+
+    // Непрерывные части до и после курсора
+    Span<T> BeforeCursor() noexcept
+    {
+        return {data_.GetAddress(), gap_begin_};
+    }
+    Span<const T> BeforeCursor() const noexcept
+    {
+        return {data_.GetAddress(), gap_begin_};
+    }
+    Span<T> AfterCursor() noexcept
+    {
+        return {data_ + gap_end_, Capacity() - gap_end_};
+    }
+    Span<const T> AfterCursor() const noexcept
+    {
+        return {data_ + gap_end_, Capacity() - gap_end_};
+    }
+
+    iterator begin() noexcept
+    {
+        return {this, 0};
+    }
+    const_iterator begin() const noexcept
+    {
+        return {this, 0};
+    }
+    const_iterator cbegin() const noexcept
+    {
+        return begin();
+    }
+    iterator end() noexcept
+    {
+        return {this, Size()};
+    }
+    const_iterator end() const noexcept
+    {
+        return {this, Size()};
+    }
+    const_iterator cend() const noexcept
+    {
+        return end();
+    }
+
+private:
+    // Переносит n элементов из from в to, диапазоны могут перекрываться. Элементы
+    // переносятся в таком порядке, чтобы каждое место назначения было уже свободно
+    static void Shift(T *from, size_t n, T *to) noexcept
+    {
+        if constexpr (IsTriviallyRelocatableV<T>)
+        {
+            if (n != 0)
+            {
+                std::memmove(static_cast<void *>(to), static_cast<const void *>(from), n * sizeof(T));
+            }
+        }
+        else if (to > from)
+        {
+            for (size_t i = n; i-- > 0;)
+            {
+                new (to + i) T(std::move(from[i]));
+                std::destroy_at(from + i);
+            }
+        }
+        else
+        {
+            for (size_t i = 0; i < n; ++i)
+            {
+                new (to + i) T(std::move(from[i]));
+                std::destroy_at(from + i);
+            }
+        }
+    }
+
+    // Переносит элементы в new_data: элементы до курсора — в начало, остальные — в конец.
+    // В new_data после первых offset элементов уже созданы created элементов, курсор
+    // оказывается после них
+    void Relocate(Memory &new_data, size_t offset, size_t created = 0) noexcept
+    {
+        const size_t tail = Capacity() - gap_end_;
+        const size_t new_gap_end = new_data.Capacity() - tail;
+        detail::RelocateN(data_.GetAddress(), gap_begin_, new_data.GetAddress());
+        detail::RelocateN(data_ + gap_end_, tail, new_data + new_gap_end);
+        data_.Swap(new_data);
+        gap_begin_ = offset + created;
+        gap_end_ = new_gap_end;
+    }
+
+    // Элементы [0, gap_begin_) и [gap_end_, Capacity()) созданы
+    Memory data_;
+    size_t gap_begin_ = 0;
+    size_t gap_end_ = 0;
+};
\ No newline at end of file
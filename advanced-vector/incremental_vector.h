@@ -0,0 +1,339 @@
+#pragma once
+#include "vector.h"
+
+// Вектор с постепенной реаллокацией. При росте новый буфер выделяется сразу, но элементы
+// переносятся в него не за одну операцию, а порциями при последующих вставках: пока идет
+// перенос, часть элементов остается в старом буфере. Каждая операция переносит не меньше
+// MIGRATION_STEP элементов и столько, чтобы перенос завершился до заполнения нового буфера,
+// поэтому ни одна вставка не переносит весь вектор.
+// Плата за ограниченную задержку — ветвление при доступе к элементу во время переноса
+// и временно удерживаемый старый буфер. Указатели-итераторы неконстантных begin()/end()
+// доступны только для непрерывного буфера, поэтому они завершают перенос. Константный вектор
+// обходится итератором по номеру элемента, который читает оба буфера и перенос не трогает.
+// Перенос не должен выбрасывать исключений: T должен быть тривиально перемещаемым или
+// иметь небросающий конструктор перемещения
+template <typename T, typename Alloc = std::allocator<T>, typename Growth = DoublingGrowth,
+          size_t MIGRATION_STEP = 64>
+class IncrementalVector
+{
+    static_assert(IsTriviallyRelocatableV<T> || std::is_nothrow_move_constructible_v<T>,
+                  "IncrementalVector requires trivially relocatable or nothrow move constructible T");
+    static_assert(MIGRATION_STEP > 0, "MIGRATION_STEP must be positive");
+
+    using Memory = RawMemory<T, Alloc>;
+
+public:
+    using allocator_type = Alloc;
+
+    IncrementalVector() = default;
+
+    explicit IncrementalVector(const Alloc &alloc) noexcept
+        : data_(alloc), old_data_(alloc)
+    {
+    }
+
+    IncrementalVector(const IncrementalVector &other)
+        : IncrementalVector(std::allocator_traits<Alloc>::select_on_container_copy_construction(other.GetAllocator())) //
+    {
+        Reserve(other.size_);
+        for (size_t i = 0; i < other.size_; ++i)
+        {
+            EmplaceBack(other[i]);
+        }
+    }
+
+    IncrementalVector(IncrementalVector &&other) noexcept
+        : data_(std::move(other.data_)),
+          old_data_(std::move(other.old_data_)),
+          size_(std::exchange(other.size_, 0)),
+          migrated_(std::exchange(other.migrated_, 0)),
+          old_size_(std::exchange(other.old_size_, 0))
+    {
+    }
+
+    ~IncrementalVector()
+    {
+        Clear();
+    }
+
+    IncrementalVector &operator=(const IncrementalVector &rhs)
+    {
+        if (this != &rhs)
+        {
+            IncrementalVector(rhs).Swap(*this);
+        }
+        return *this;
+    }
+
+    IncrementalVector &operator=(IncrementalVector &&rhs) noexcept
+    {
+        if (this != &rhs)
+        {
+            Clear();
+            Swap(rhs);
+        }
+        return *this;
+    }
+
+    void Swap(IncrementalVector &other) noexcept
+    {
+        data_.Swap(other.data_);
+        old_data_.Swap(other.old_data_);
+        std::swap(size_, other.size_);
+        std::swap(migrated_, other.migrated_);
+        std::swap(old_size_, other.old_size_);
+    }
+
+    const Alloc &GetAllocator() const noexcept
+    {
+        return data_.GetAllocator();
+    }
+
+    size_t Size() const noexcept
+    {
+        return size_;
+    }
+
+    size_t Capacity() const noexcept
+    {
+        return data_.Capacity();
+    }
+
+    // Часть элементов еще находится в старом буфере
+    bool IsMigrating() const noexcept
+    {
+        return old_data_.GetAddress() != nullptr;
+    }
+
+    // Выделяет буфер емкости new_capacity. Элементы переносятся в него постепенно
+    void Reserve(size_t new_capacity)
+    {
+        if (new_capacity > Capacity())
+        {
+            BeginMigration(Memory(new_capacity, GetAllocator()));
+        }
+    }
+
+    // Переносит в новый буфер все оставшиеся элементы
+    void FinishMigration() noexcept
+    {
+        Migrate(old_size_ - migrated_);
+    }
+
+    void Clear() noexcept
+    {
+        std::destroy_n(data_.GetAddress(), migrated_);
+        std::destroy_n(old_data_.GetAddress() + migrated_, old_size_ - migrated_);
+        std::destroy(data_.GetAddress() + old_size_, data_.GetAddress() + size_);
+        ResetMigration();
+        size_ = 0;
+    }
+
+    void PushBack(const T &value)
+    {
+        EmplaceBack(value);
+    }
+    void PushBack(T &&value)
+    {
+        EmplaceBack(std::move(value));
+    }
+
+    // Добавляет элемент в конец и переносит очередную порцию элементов. Если конструктор
+    // элемента выбросит исключение, вектор не изменится
+    template <typename... Args>
+    T &EmplaceBack(Args &&...args)
+    {
+        if (size_ == Capacity())
+        {
+            // Предыдущий перенос к этому моменту уже завершен
+            FinishMigration();
+            Memory new_data(Growth::NextCapacity(Capacity(), sizeof(T)), GetAllocator());
+            // Старый буфер остается на месте, поэтому аргументы могут ссылаться на элементы вектора
+            new (new_data + size_) T(std::forward<Args>(args)...);
+            BeginMigration(std::move(new_data));
+        }
+        else
+        {
+            new (data_ + size_) T(std::forward<Args>(args)...);
+        }
+        T &result = data_[size_];
+        ++size_;
+        MigrateStep();
+        return result;
+    }
+
+    void PopBack() noexcept
+    {
+        assert(size_ > 0);
+        const size_t last = size_ - 1;
+        if (last < old_size_ && last >= migrated_)
+        {
+            // Новых элементов после начала переноса нет, последний лежит в старом буфере
+            std::destroy_at(old_data_ + last);
+            old_size_ = last;
+            if (migrated_ == old_size_)
+            {
+                ResetMigration();
+            }
+        }
+        else
+        {
+            std::destroy_at(data_ + last);
+        }
+        --size_;
+    }
+
+    const T &operator[](size_t index) const noexcept
+    {
+        return const_cast<IncrementalVector &>(*this)[index];
+    }
+
+    T &operator[](size_t index) noexcept
+    {
+        assert(index < size_);
+        if (index >= migrated_ && index < old_size_)
+        {
+            return old_data_[index];
+        }
+        return data_[index];
+    }
+
+    using iterator = T *;
+
+    class const_iterator
+    {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const T *;
+        using reference = const T &;
+
+        const_iterator(const IncrementalVector *owner, size_t index) noexcept
+            : owner_(owner), index_(index)
+        {
+        }
+
+        const T &operator*() const noexcept
+        {
+            return (*owner_)[index_];
+        }
+        const T *operator->() const noexcept
+        {
+            return &(*owner_)[index_];
+        }
+        const_iterator &operator++() noexcept
+        {
+            ++index_;
+            return *this;
+        }
+        const_iterator operator++(int) noexcept
+        {
+            const_iterator old = *this;
+            ++index_;
+            return old;
+        }
+        bool operator==(const const_iterator &other) const noexcept
+        {
+            return index_ == other.index_;
+        }
+        bool operator!=(const const_iterator &other) const noexcept
+        {
+            return index_ != other.index_;
+        }
+
+    private:
+        const IncrementalVector *owner_;
+        size_t index_;
+    };
+
+    // Завершает перенос: итерировать можно только непрерывный буфер
+    iterator begin() noexcept
+    {
+        FinishMigration();
+        return data_.GetAddress();
+    }
+
+    iterator end() noexcept
+    {
+        FinishMigration();
+        return data_.GetAddress() + size_;
+    }
+
+    const_iterator begin() const noexcept
+    {
+        return {this, 0};
+    }
+    const_iterator end() const noexcept
+    {
+        return {this, size_};
+    }
+    const_iterator cbegin() const noexcept
+    {
+        return begin();
+    }
+    const_iterator cend() const noexcept
+    {
+        return end();
+    }
+
+private:
+    // Делает new_data текущим буфером. Элементы, которые в нем еще не созданы, остаются
+    // в старом буфере до переноса
+    void BeginMigration(Memory &&new_data) noexcept
+    {
+        FinishMigration();
+        old_data_ = std::move(data_);
+        data_ = std::move(new_data);
+        migrated_ = 0;
+        old_size_ = size_;
+        if (old_size_ == 0)
+        {
+            ResetMigration();
+        }
+    }
+
+    // Переносит порцию, достаточную для завершения переноса до заполнения буфера
+    void MigrateStep() noexcept
+    {
+        if (!IsMigrating())
+        {
+            return;
+        }
+        const size_t remaining = old_size_ - migrated_;
+        const size_t free_slots = Capacity() - size_;
+        const size_t needed = free_slots == 0 ? remaining : (remaining + free_slots - 1) / free_slots;
+        Migrate(std::min(remaining, std::max(MIGRATION_STEP, needed)));
+    }
+
+    void Migrate(size_t count) noexcept
+    {
+        if (count == 0)
+        {
+            return;
+        }
+        detail::RelocateN(old_data_ + migrated_, count, data_ + migrated_);
+        migrated_ += count;
+        if (migrated_ == old_size_)
+        {
+            ResetMigration();
+        }
+    }
+
+    // Освобождает старый буфер: все элементы находятся в текущем
+    void ResetMigration() noexcept
+    {
+        Memory empty(GetAllocator());
+        old_data_.Swap(empty);
+        migrated_ = 0;
+        old_size_ = 0;
+    }
+
+    // Элементы [0, migrated_) и [old_size_, size_) находятся в data_,
+    // элементы [migrated_, old_size_) — в old_data_
+    Memory data_;
+    Memory old_data_;
+    size_t size_ = 0;
+    size_t migrated_ = 0;
+    size_t old_size_ = 0;
+};
\ No newline at end of file
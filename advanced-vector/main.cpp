@@ -1,8 +1,30 @@
+#include "concurrent_vector.h"
+#include "cow_vector.h"
+#include "fixed_vector.h"
+#include "flat_map.h"
+#include "gap_vector.h"
+#include "incremental_vector.h"
+#include "mapped_vector.h"
+#include "pool_allocator.h"
+#include "segmented_vector.h"
+#include "small_vector.h"
+#include "soa_vector.h"
 #include "vector.h"
+#include "vector_io.h"
+#include "vector_profiler.h"
+#include "vector_simd.h"
 
+#include <atomic>
+#include <cstdio>
+#include <fstream>
 #include <iostream>
+#include <limits>
+#include <map>
+#include <numeric>
+#include <sstream>
 #include <stdexcept>
 #include <string>
+#include <thread>
 #include <vector>
 
 namespace
@@ -129,8 +151,200 @@ namespace
         static inline int num_move_assigned = 0;
     };
 
+    // Аллокатор с состоянием: ведет учет живых выделений отдельно для каждого id
+    template <typename T, bool Propagate>
+    struct TrackingAllocator
+    {
+        using value_type = T;
+        using propagate_on_container_copy_assignment = std::bool_constant<Propagate>;
+        using propagate_on_container_move_assignment = std::bool_constant<Propagate>;
+        using propagate_on_container_swap = std::bool_constant<Propagate>;
+        using is_always_equal = std::false_type;
+
+        template <typename U>
+        struct rebind
+        {
+            using other = TrackingAllocator<U, Propagate>;
+        };
+
+        explicit TrackingAllocator(int id = 0) noexcept
+            : id(id) //
+        {
+        }
+
+        template <typename U>
+        TrackingAllocator(const TrackingAllocator<U, Propagate> &other) noexcept
+            : id(other.id) //
+        {
+        }
+
+        T *allocate(size_t n)
+        {
+            peak_allocations[id] = std::max(peak_allocations[id], ++live_allocations[id]);
+            return static_cast<T *>(operator new(n * sizeof(T)));
+        }
+
+        void deallocate(T *p, size_t /*n*/) noexcept
+        {
+            --live_allocations[id];
+            operator delete(p);
+        }
+
+        bool operator==(const TrackingAllocator &other) const noexcept
+        {
+            return id == other.id;
+        }
+
+        bool operator!=(const TrackingAllocator &other) const noexcept
+        {
+            return id != other.id;
+        }
+
+        int id = 0;
+
+        static inline int live_allocations[4] = {};
+        static inline int peak_allocations[4] = {};
+    };
+
+    // Владеющий дескриптор: не тривиально копируемый, но объявленный тривиально перемещаемым
+    struct Handle
+    {
+        Handle()
+            : value(new int(0)) //
+        {
+        }
+
+        explicit Handle(int v)
+            : value(new int(v)) //
+        {
+        }
+
+        Handle(const Handle &other)
+            : value(new int(*other.value)) //
+        {
+            ++num_copied;
+        }
+
+        Handle(Handle &&other) noexcept
+            : value(std::exchange(other.value, nullptr)) //
+        {
+            ++num_moved;
+        }
+
+        Handle &operator=(const Handle &other)
+        {
+            *value = *other.value;
+            return *this;
+        }
+
+        Handle &operator=(Handle &&other) noexcept
+        {
+            std::swap(value, other.value);
+            return *this;
+        }
+
+        ~Handle()
+        {
+            delete value;
+        }
+
+        int *value = nullptr;
+
+        static inline int num_copied = 0;
+        static inline int num_moved = 0;
+    };
+
+    // Аллокатор, всегда резервирующий MAX_SIZE элементов и потому умеющий расширять блок на месте
+    template <typename T>
+    struct ExpandingAllocator
+    {
+        static constexpr size_t MAX_SIZE = 1024;
+
+        using value_type = T;
+
+        ExpandingAllocator() = default;
+
+        template <typename U>
+        ExpandingAllocator(const ExpandingAllocator<U> & /*other*/) noexcept
+        {
+        }
+
+        T *allocate(size_t n)
+        {
+            assert(n <= MAX_SIZE);
+            return static_cast<T *>(operator new(MAX_SIZE * sizeof(T)));
+        }
+
+        void deallocate(T *p, size_t /*n*/) noexcept
+        {
+            operator delete(p);
+        }
+
+        bool try_expand(T * /*p*/, size_t /*old_n*/, size_t new_n) noexcept
+        {
+            if (new_n > MAX_SIZE)
+            {
+                return false;
+            }
+            ++num_expansions;
+            return true;
+        }
+
+        template <typename U>
+        bool operator==(const ExpandingAllocator<U> & /*other*/) const noexcept
+        {
+            return true;
+        }
+
+        template <typename U>
+        bool operator!=(const ExpandingAllocator<U> & /*other*/) const noexcept
+        {
+            return false;
+        }
+
+        static inline int num_expansions = 0;
+    };
+
+    // Элемент для параллельных операций: счетчик атомарный, так как элементы создаются
+    // и уничтожаются в разных потоках
+    struct Counted
+    {
+        Counted() noexcept
+        {
+            ++alive;
+        }
+        Counted(const Counted &other)
+            : value(other.value)
+        {
+            if (other.value == THROW_ON_COPY)
+            {
+                throw std::runtime_error("Oops");
+            }
+            ++alive;
+        }
+        // Перемещение может выбросить исключение, поэтому при росте элементы копируются
+        Counted(Counted &&other) noexcept(false)
+            : Counted(static_cast<const Counted &>(other))
+        {
+        }
+        Counted &operator=(const Counted &) = default;
+        ~Counted()
+        {
+            --alive;
+        }
+
+        static constexpr int THROW_ON_COPY = -1;
+        static inline std::atomic<int> alive{0};
+        int value = 0;
+    };
+
 } // namespace
 
+template <>
+struct IsTriviallyRelocatable<Handle> : std::true_type
+{
+};
+
 void Test1()
 {
     Obj::ResetCounters();
@@ -587,102 +801,2415 @@ void Test6()
     }
 }
 
-struct C
+void Test7()
 {
-    C() noexcept
+    const size_t SIZE = 10;
+    using PropAlloc = TrackingAllocator<Obj, true>;
+    using NonPropAlloc = TrackingAllocator<Obj, false>;
     {
-        ++def_ctor;
+        Obj::ResetCounters();
+        Vector<Obj, PropAlloc> v(SIZE, PropAlloc{1});
+        v.PushBack(Obj{1});
+        assert(PropAlloc::live_allocations[1] == 1);
+        Vector<Obj, PropAlloc> v_copy(v);
+        assert(v_copy.GetAllocator().id == 1);
+        assert(PropAlloc::live_allocations[1] == 2);
+
+        Vector<Obj, PropAlloc> v_other(SIZE * 3, PropAlloc{2});
+        v_other = v;
+        // Аллокатор распространяется при копировании, память аллокатора 2 освобождена
+        assert(v_other.GetAllocator().id == 1);
+        assert(v_other.Size() == SIZE + 1);
+        assert(PropAlloc::live_allocations[2] == 0);
+
+        Vector<Obj, PropAlloc> v_moved(PropAlloc{3});
+        v_moved = std::move(v_copy);
+        assert(v_moved.GetAllocator().id == 1);
+        assert(v_moved.Size() == SIZE + 1);
+
+        Vector<Obj, PropAlloc> v_swapped(1, PropAlloc{2});
+        v_swapped.Swap(v_moved);
+        assert(v_swapped.GetAllocator().id == 1);
+        assert(v_moved.GetAllocator().id == 2);
+        assert(v_moved.Size() == 1);
     }
-    C(const C & /*other*/) noexcept
+    assert(PropAlloc::live_allocations[1] == 0);
+    assert(PropAlloc::live_allocations[2] == 0);
+    assert(PropAlloc::live_allocations[3] == 0);
+    assert(Obj::GetAliveObjectCount() == 0);
     {
-        ++copy_ctor;
+        Obj::ResetCounters();
+        Vector<Obj, NonPropAlloc> v(SIZE, NonPropAlloc{1});
+        Vector<Obj, NonPropAlloc> v_other(SIZE / 2, NonPropAlloc{2});
+        v_other = v;
+        // Аллокатор не распространяется: копия строится в памяти аллокатора 2
+        assert(v_other.GetAllocator().id == 2);
+        assert(v_other.Size() == SIZE);
+        assert(NonPropAlloc::live_allocations[2] == 1);
+
+        const int old_num_moved = Obj::num_moved;
+        v_other = std::move(v);
+        assert(v_other.GetAllocator().id == 2);
+        assert(v_other.Size() == SIZE);
+        assert(Obj::num_moved == old_num_moved + static_cast<int>(SIZE));
+        assert(NonPropAlloc::live_allocations[1] == 1);
+        assert(NonPropAlloc::live_allocations[2] == 1);
     }
-    C(C && /*other*/) noexcept
+    assert(NonPropAlloc::live_allocations[1] == 0);
+    assert(NonPropAlloc::live_allocations[2] == 0);
+    assert(Obj::GetAliveObjectCount() == 0);
+}
+
+void Test8()
+{
+    const int SIZE = 64;
+    static_assert(IsTriviallyRelocatableV<int>);
+    static_assert(!IsTriviallyRelocatableV<Obj>);
     {
-        ++move_ctor;
+        Vector<int> v;
+        for (int i = 0; i < SIZE; ++i)
+        {
+            v.PushBack(i);
+        }
+        v.Insert(v.cbegin() + SIZE / 2, -1);
+        v.Reserve(SIZE * 4);
+        assert(v.Size() == SIZE + 1);
+        assert(v[SIZE / 2] == -1);
+        assert(v[SIZE / 2 - 1] == SIZE / 2 - 1);
+        assert(v[SIZE / 2 + 1] == SIZE / 2);
+        assert(v[SIZE] == SIZE - 1);
     }
-    C &operator=(const C &other) noexcept
     {
-        if (this != &other)
+        Handle::num_copied = 0;
+        Handle::num_moved = 0;
+        Vector<Handle> v;
+        for (int i = 0; i < SIZE; ++i)
         {
-            ++copy_assign;
+            v.EmplaceBack(i);
+        }
+        v.Reserve(SIZE * 2);
+        // Рост вектора переносит элементы побайтово, не вызывая конструкторов
+        assert(Handle::num_copied == 0);
+        assert(Handle::num_moved == 0);
+        v.Emplace(v.cbegin(), -1);
+        assert(v.Size() == SIZE + 1);
+        assert(*v[0].value == -1);
+        for (int i = 0; i < SIZE; ++i)
+        {
+            assert(*v[i + 1].value == i);
         }
-        return *this;
     }
-    C &operator=(C && /*other*/) noexcept
     {
-        ++move_assign;
-        return *this;
+        Handle::num_moved = 0;
+        Vector<Handle> v(4);
+        v.Emplace(v.cbegin() + 1, 7);
+        assert(Handle::num_moved == 0);
+        assert(v.Size() == 5);
+        assert(*v[1].value == 7);
+        assert(*v[4].value == 0);
+    }
+}
+
+void Test9()
+{
+    const int SIZE = 1024;
+    {
+        Vector<int, MallocAllocator<int>> v;
+        for (int i = 0; i < SIZE; ++i)
+        {
+            v.PushBack(i);
+        }
+        assert(v.Size() == v.Capacity());
+        // Вставляемый элемент ссылается на буфер, который переедет при realloc
+        v.Insert(v.cbegin() + 1, v[SIZE - 1]);
+        assert(v.Size() == SIZE + 1);
+        assert(v[0] == 0);
+        assert(v[1] == SIZE - 1);
+        assert(v[2] == 1);
+        assert(v[SIZE] == SIZE - 1);
+        v.Reserve(SIZE * 4);
+        assert(v.Capacity() == SIZE * 4);
+        assert(v[SIZE] == SIZE - 1);
     }
-    ~C()
     {
-        ++dtor;
+        Obj::ResetCounters();
+        Vector<Obj, ExpandingAllocator<Obj>> v(10);
+        Obj *const data = &v[0];
+        v.Reserve(20);
+        v.EmplaceBack(1);
+        for (int i = 0; i < 100; ++i)
+        {
+            v.EmplaceBack(i);
+        }
+        // Буфер расширяется на месте: элементы не перемещаются и не копируются
+        assert(&v[0] == data);
+        assert(v.Capacity() >= v.Size());
+        assert(ExpandingAllocator<Obj>::num_expansions > 0);
+        assert(Obj::num_moved == 0);
+        assert(Obj::num_copied == 0);
     }
+    assert(Obj::GetAliveObjectCount() == 0);
+}
 
-    static void Reset()
+void Test10()
+{
     {
-        def_ctor = 0;
-        copy_ctor = 0;
-        move_ctor = 0;
-        copy_assign = 0;
-        move_assign = 0;
-        dtor = 0;
+        Vector<int, std::allocator<int>, OneAndHalfGrowth> v;
+        const size_t expected[] = {1, 2, 3, 4, 6, 9, 13, 19};
+        for (size_t capacity : expected)
+        {
+            v.PushBack(0);
+            while (v.Size() < v.Capacity())
+            {
+                v.PushBack(0);
+            }
+            assert(v.Capacity() == capacity);
+        }
     }
+    {
+        using Growth = SizeClassGrowth<OneAndHalfGrowth, 4096>;
+        // Небольшие буферы округляются до степени двойки байт
+        assert(Growth::NextCapacity(0, sizeof(int)) == 4);
+        assert(Growth::NextCapacity(4, sizeof(int)) == 8);
+        assert(Growth::NextCapacity(8, sizeof(int)) == 16);
+        assert(Growth::NextCapacity(3, 24) == 5);
+        // Крупные — до целого числа страниц
+        assert(Growth::NextCapacity(1000, sizeof(int)) == 2048);
+        assert(Growth::NextCapacity(2048, sizeof(int)) == 3072);
+        assert(Growth::NextCapacity(1, 5000) == 2);
 
-    inline static size_t def_ctor = 0;
-    inline static size_t copy_ctor = 0;
-    inline static size_t move_ctor = 0;
-    inline static size_t copy_assign = 0;
-    inline static size_t move_assign = 0;
-    inline static size_t dtor = 0;
-};
+        Vector<Obj, std::allocator<Obj>, Growth> v;
+        v.EmplaceBack(1);
+        assert(v.Capacity() * sizeof(Obj) <= 64);
+        assert(v.Capacity() >= 1);
+    }
+    {
+        Vector<int, std::allocator<int>, DoublingGrowth> v(5);
+        v.PushBack(1);
+        assert(v.Capacity() == 10);
+    }
+}
 
-void Dump()
+void Test11()
 {
-    using namespace std;
-    cerr << "Def ctors: "sv << C::def_ctor             //
-         << ", Copy ctors: "sv << C::copy_ctor         //
-         << ", Move ctors: "sv << C::move_ctor         //
-         << ", Copy assignments: "sv << C::copy_assign //
-         << ", Move assignments: "sv << C::move_assign //
-         << ", Dtors: "sv << C::dtor << endl;
+    const size_t N = 4;
+    const int ID = 42;
+    {
+        Obj::ResetCounters();
+        SmallVector<Obj, N> v;
+        assert(v.IsInline());
+        assert(v.Capacity() == N);
+        for (size_t i = 0; i < N; ++i)
+        {
+            v.EmplaceBack(static_cast<int>(i));
+        }
+        assert(v.IsInline());
+        assert(Obj::num_moved == 0);
+        v.Insert(v.cbegin(), Obj{ID});
+        assert(!v.IsInline());
+        assert(v.Size() == N + 1);
+        assert(v.Capacity() == N * 2);
+        assert(v[0].id == ID);
+        assert(v[N].id == static_cast<int>(N - 1));
+        v.Erase(v.cbegin());
+        assert(v[0].id == 0);
+        assert(v.Size() == N);
+    }
+    assert(Obj::GetAliveObjectCount() == 0);
+    {
+        Obj::ResetCounters();
+        SmallVector<Obj, N> small(N / 2);
+        SmallVector<Obj, N> large(N * 3);
+        small[0].id = ID;
+        large[N * 3 - 1].id = ID;
+
+        SmallVector<Obj, N> small_copy(small);
+        assert(small_copy.IsInline());
+        assert(small_copy[0].id == ID);
+        SmallVector<Obj, N> large_copy(large);
+        assert(!large_copy.IsInline());
+        assert(large_copy[N * 3 - 1].id == ID);
+
+        small_copy.Swap(large_copy);
+        assert(small_copy.Size() == N * 3);
+        assert(large_copy.Size() == N / 2);
+        assert(large_copy.IsInline());
+        assert(large_copy[0].id == ID);
+
+        SmallVector<Obj, N> moved(std::move(small_copy));
+        assert(moved.Size() == N * 3);
+        assert(small_copy.Size() == 0);
+        assert(small_copy.IsInline());
+
+        moved = small;
+        assert(moved.Size() == N / 2);
+        assert(moved[0].id == ID);
+        small = large;
+        assert(small.Size() == N * 3);
+        assert(small[N * 3 - 1].id == ID);
+
+        moved.Resize(N * 5);
+        assert(moved.Size() == N * 5);
+        moved.Resize(1);
+        assert(moved.Size() == 1);
+        assert(moved[0].id == ID);
+    }
+    assert(Obj::GetAliveObjectCount() == 0);
+    {
+        Obj::ResetCounters();
+        SmallVector<Obj, N> v(N);
+        v[1].throw_on_copy = true;
+        // Вставка без реаллокации
+        v.PopBack();
+        try
+        {
+            v.Insert(v.cbegin(), v[1]);
+            assert(false && "Exception is expected");
+        }
+        catch (const std::runtime_error &)
+        {
+        }
+        assert(v.Size() == N - 1);
+        assert(Obj::GetAliveObjectCount() == N - 1);
+    }
+    assert(Obj::GetAliveObjectCount() == 0);
+    {
+        SmallVector<TestObj, N> v(N);
+        v.PushBack(v[0]);
+        v.Insert(v.cbegin() + 2, v[0]);
+        assert(std::all_of(v.begin(), v.end(), [](const TestObj &obj)
+                           { return obj.IsAlive(); }));
+    }
+    {
+        SmallVector<int, N> v;
+        for (int i = 0; i < 100; ++i)
+        {
+            v.Insert(v.cbegin(), i);
+        }
+        assert(v.Size() == 100);
+        assert(v[0] == 99);
+        assert(v[99] == 0);
+    }
+    {
+        using PropAlloc = TrackingAllocator<Obj, true>;
+        using NonPropAlloc = TrackingAllocator<Obj, false>;
+        Obj::ResetCounters();
+        {
+            // Аллокатор распространяется: буфер забирается вместе с аллокатором rhs
+            SmallVector<Obj, N, PropAlloc> lhs(N * 2, PropAlloc(1));
+            SmallVector<Obj, N, PropAlloc> rhs(N * 3, PropAlloc(2));
+            const int live = PropAlloc::live_allocations[1];
+            lhs = std::move(rhs);
+            assert(lhs.GetAllocator().id == 2 && lhs.Size() == N * 3 && rhs.Size() == 0);
+            assert(PropAlloc::live_allocations[1] == live - 1 && Obj::num_moved == 0);
+
+            // Встроенные элементы переезжают по одному, буфер в куче мест не меняет
+            SmallVector<Obj, N, PropAlloc> small(N / 2, PropAlloc(1));
+            small[0].id = ID;
+            small.Swap(lhs);
+            assert(small.GetAllocator().id == 2 && small.Size() == N * 3 && !small.IsInline());
+            assert(lhs.GetAllocator().id == 1 && lhs.IsInline() && lhs[0].id == ID);
+            assert(Obj::num_moved == N / 2);
+
+            // Копия помещается в имеющийся буфер, но аллокатор все равно распространяется:
+            // буфер в куче освобождается нашим аллокатором
+            SmallVector<Obj, N, PropAlloc> heap_lhs(N * 3, PropAlloc(3));
+            SmallVector<Obj, N, PropAlloc> small_rhs(N / 2, PropAlloc(1));
+            small_rhs[0].id = ID;
+            heap_lhs = small_rhs;
+            assert(heap_lhs.GetAllocator().id == 1 && heap_lhs.IsInline() && heap_lhs.Size() == N / 2);
+            assert(heap_lhs[0].id == ID && PropAlloc::live_allocations[3] == 0);
+            SmallVector<Obj, N, PropAlloc> inline_lhs(N, PropAlloc(3));
+            inline_lhs = small_rhs;
+            assert(inline_lhs.GetAllocator().id == 1 && inline_lhs.Size() == N / 2 && inline_lhs[0].id == ID);
+        }
+        assert(Obj::GetAliveObjectCount() == 0);
+        Obj::ResetCounters();
+        {
+            // Аллокатор не распространяется и не равен: элементы переносятся в наш буфер
+            SmallVector<Obj, N, NonPropAlloc> lhs(NonPropAlloc(1));
+            SmallVector<Obj, N, NonPropAlloc> rhs(N * 3, NonPropAlloc(2));
+            rhs[N * 3 - 1].id = ID;
+            lhs = std::move(rhs);
+            assert(lhs.GetAllocator().id == 1 && lhs.Size() == N * 3 && lhs[N * 3 - 1].id == ID);
+            assert(rhs.Size() == 0 && rhs.GetAllocator().id == 2);
+            assert(Obj::num_moved == N * 3);
+
+            // Копирующее присваивание с ростом сохраняет аллокатор левой части
+            SmallVector<Obj, N, NonPropAlloc> copy(NonPropAlloc(3));
+            copy = lhs;
+            assert(copy.GetAllocator().id == 3 && copy.Size() == N * 3 && copy[N * 3 - 1].id == ID);
+        }
+        assert(Obj::GetAliveObjectCount() == 0);
+    }
 }
 
-void Benchmark()
+void Test12()
 {
-    using namespace std;
-    try
+    using namespace std::literals;
+    {
+        Vector<int> v;
+        const std::vector<int> src = {1, 2, 3, 4, 5};
+        v.Append(src);
+        assert(v.Size() == 5);
+        assert(v.Capacity() == 5);
+        v.Insert(v.cbegin() + 1, src.begin(), src.begin() + 2);
+        const int expected[] = {1, 1, 2, 2, 3, 4, 5};
+        assert(std::equal(v.begin(), v.end(), std::begin(expected), std::end(expected)));
+        v.Insert(v.cbegin(), 2, v[6]);
+        assert(v.Size() == 9);
+        assert(v[0] == 5 && v[1] == 5 && v[2] == 1 && v[8] == 5);
+        v.Insert(v.cend(), 0, 7);
+        assert(v.Size() == 9);
+    }
+    {
+        // Вставка с реаллокацией выполняется за один рост емкости
+        Obj::ResetCounters();
+        Vector<Obj> v(3);
+        std::vector<Obj> src(10);
+        const int old_num_moved = Obj::num_moved;
+        v.Insert(v.cbegin() + 1, src.begin(), src.end());
+        assert(v.Size() == 13);
+        assert(v.Capacity() == 13);
+        assert(Obj::num_moved == old_num_moved + 3);
+        assert(Obj::num_copied == 10);
+    }
+    assert(Obj::GetAliveObjectCount() == 0);
+    {
+        // Вставка без реаллокации: длинный хвост
+        Obj::ResetCounters();
+        Vector<Obj> v;
+        v.Reserve(20);
+        for (int i = 0; i < 10; ++i)
+        {
+            v.EmplaceBack(i);
+        }
+        const Obj values[] = {Obj{100}, Obj{101}};
+        v.Insert(v.cbegin() + 2, std::begin(values), std::end(values));
+        assert(v.Size() == 12);
+        assert(v.Capacity() == 20);
+        const int ids[] = {0, 1, 100, 101, 2, 3, 4, 5, 6, 7, 8, 9};
+        for (size_t i = 0; i < v.Size(); ++i)
+        {
+            assert(v[i].id == ids[i]);
+        }
+        // Короткий хвост
+        v.Insert(v.cbegin() + 11, 3, Obj{7});
+        const int ids2[] = {0, 1, 100, 101, 2, 3, 4, 5, 6, 7, 8, 7, 7, 7, 9};
+        assert(v.Size() == 15);
+        for (size_t i = 0; i < v.Size(); ++i)
+        {
+            assert(v[i].id == ids2[i]);
+        }
+    }
+    assert(Obj::GetAliveObjectCount() == 0);
     {
-        const size_t NUM = 10;
-        C c;
+        // При исключении во время вставки с реаллокацией вектор не меняется
+        Obj::ResetCounters();
+        Vector<Obj> v(4);
+        std::vector<Obj> src(4);
+        src[2].throw_on_copy = true;
+        try
+        {
+            v.Insert(v.cbegin() + 1, src.begin(), src.end());
+            assert(false && "Exception is expected");
+        }
+        catch (const std::runtime_error &)
         {
-            cerr << "std::vector:"sv << endl;
-            C::Reset();
-            vector<C> v(NUM);
-            Dump();
-            v.push_back(c);
         }
-        Dump();
+        assert(v.Size() == 4);
+        assert(v.Capacity() == 4);
+        assert(Obj::GetAliveObjectCount() == 8);
     }
-    catch (...)
+    assert(Obj::GetAliveObjectCount() == 0);
     {
+        // Входные итераторы
+        std::istringstream input("1 2 3 4"s);
+        Vector<int> v(2);
+        v.Insert(v.cbegin() + 1, std::istream_iterator<int>(input), std::istream_iterator<int>());
+        const int expected[] = {0, 1, 2, 3, 4, 0};
+        assert(std::equal(v.begin(), v.end(), std::begin(expected), std::end(expected)));
     }
-    try
     {
-        const size_t NUM = 10;
-        C c;
+        Vector<TestObj> v(3);
+        v.Insert(v.cbegin(), 5, v[2]);
+        assert(std::all_of(v.begin(), v.end(), [](const TestObj &obj)
+                           { return obj.IsAlive(); }));
+        v.Reserve(20);
+        v.Insert(v.cbegin() + 1, 4, v[7]);
+        assert(v.Size() == 12);
+        assert(std::all_of(v.begin(), v.end(), [](const TestObj &obj)
+                           { return obj.IsAlive(); }));
+    }
+    {
+        Obj::ResetCounters();
+        Vector<Obj> v(10);
+        const std::vector<Obj> small(3, Obj{1});
+        v.AssignRange(small);
+        assert(v.Size() == 3);
+        assert(v.Capacity() == 10);
+        assert(v[2].id == 1);
+        assert(Obj::num_assigned == 3);
+        const std::vector<Obj> large(20, Obj{2});
+        v.AssignRange(large.begin(), large.end());
+        assert(v.Size() == 20);
+        assert(v[19].id == 2);
+        std::istringstream input("5 6 7"s);
+        Vector<int> ints(1);
+        ints.AssignRange(std::istream_iterator<int>(input), std::istream_iterator<int>());
+        assert(ints.Size() == 3);
+        assert(ints[0] == 5 && ints[2] == 7);
+    }
+    assert(Obj::GetAliveObjectCount() == 0);
+}
+
+void Test13()
+{
+    const size_t SIZE = 10;
+    {
+        Obj::ResetCounters();
+        Vector<Obj> v;
+        for (size_t i = 0; i < SIZE; ++i)
         {
-            cerr << "Vector:"sv << endl;
-            C::Reset();
-            Vector<C> v(NUM);
-            Dump();
-            v.PushBack(c);
+            v.EmplaceBack(static_cast<int>(i));
         }
-        Dump();
+        auto *pos = v.Erase(v.cbegin() + 2, v.cbegin() + 5);
+        assert(pos == v.begin() + 2);
+        assert(v.Size() == SIZE - 3);
+        assert(v.Capacity() == 16);
+        assert(v[2].id == 5);
+        assert(v[SIZE - 4].id == static_cast<int>(SIZE - 1));
+        assert(Obj::num_move_assigned == SIZE - 5);
+        assert(Obj::GetAliveObjectCount() == static_cast<int>(SIZE - 3));
+
+        v.Erase(v.cbegin() + 1, v.cbegin() + 1);
+        assert(v.Size() == SIZE - 3);
+        v.Erase(v.cbegin(), v.cend());
+        assert(v.Size() == 0);
+        assert(Obj::GetAliveObjectCount() == 0);
     }
-    catch (...)
     {
+        Obj::ResetCounters();
+        Vector<Obj> v;
+        for (size_t i = 0; i < SIZE; ++i)
+        {
+            v.EmplaceBack(static_cast<int>(i));
+        }
+        const size_t removed = v.EraseIf([](const Obj &obj)
+                                         { return obj.id % 3 == 0; });
+        assert(removed == 4);
+        assert(v.Size() == SIZE - 4);
+        const int ids[] = {1, 2, 4, 5, 7, 8};
+        for (size_t i = 0; i < v.Size(); ++i)
+        {
+            assert(v[i].id == ids[i]);
+        }
+        assert(Obj::GetAliveObjectCount() == static_cast<int>(SIZE - 4));
+    }
+    assert(Obj::GetAliveObjectCount() == 0);
+    {
+        Vector<Handle> v;
+        for (int i = 0; i < static_cast<int>(SIZE); ++i)
+        {
+            v.EmplaceBack(i);
+        }
+        v.Erase(v.cbegin() + 1, v.cbegin() + 4);
+        assert(v.Size() == SIZE - 3);
+        assert(*v[0].value == 0);
+        assert(*v[1].value == 4);
+        assert(*v[SIZE - 4].value == static_cast<int>(SIZE - 1));
+        v.EraseIf([](const Handle &h)
+                  { return *h.value % 2 == 0; });
+        assert(v.Size() == 3);
+        assert(*v[0].value == 5 && *v[1].value == 7 && *v[2].value == 9);
+    }
+}
+
+void Test14()
+{
+    const size_t SIZE = 5;
+    {
+        Obj::ResetCounters();
+        Vector<Obj> v;
+        for (size_t i = 0; i < SIZE; ++i)
+        {
+            v.EmplaceBack(static_cast<int>(i));
+        }
+        auto *pos = v.SwapErase(v.cbegin() + 1);
+        assert(pos == v.begin() + 1);
+        assert(v.Size() == SIZE - 1);
+        assert(v[1].id == static_cast<int>(SIZE - 1));
+        assert(Obj::num_move_assigned == 1);
+        assert(Obj::GetAliveObjectCount() == static_cast<int>(SIZE - 1));
+
+        pos = v.SwapErase(v.cbegin() + v.Size() - 1);
+        assert(pos == v.end());
+        assert(v.Size() == SIZE - 2);
+        assert(Obj::num_move_assigned == 1);
+        assert(Obj::GetAliveObjectCount() == static_cast<int>(SIZE - 2));
+    }
+    assert(Obj::GetAliveObjectCount() == 0);
+    {
+        Vector<Handle> v;
+        for (int i = 0; i < static_cast<int>(SIZE); ++i)
+        {
+            v.EmplaceBack(i);
+        }
+        v.SwapErase(v.cbegin());
+        assert(v.Size() == SIZE - 1);
+        assert(*v[0].value == static_cast<int>(SIZE - 1));
+        assert(*v[1].value == 1);
+        while (v.Size() > 0)
+        {
+            v.SwapErase(v.cbegin());
+        }
+    }
+}
+
+void Test15()
+{
+    const size_t SIZE = 100;
+    {
+        Vector<int> v(SIZE);
+        std::fill(v.begin(), v.end(), 7);
+        v.Resize(SIZE / 2);
+        // Resize, как и конструктор, инициализирует новые элементы значением
+        v.Resize(SIZE);
+        assert(std::all_of(v.begin() + SIZE / 2, v.end(), [](int x)
+                           { return x == 0; }));
+    }
+    {
+        Vector<int> v(SIZE, DEFAULT_INIT);
+        assert(v.Size() == SIZE);
+        assert(v.Capacity() == SIZE);
+        std::fill(v.begin(), v.end(), 1);
+        v.ResizeUninitialized(SIZE * 2);
+        assert(v.Size() == SIZE * 2);
+        assert(v[SIZE - 1] == 1);
+        v.ResizeUninitialized(1);
+        assert(v.Size() == 1);
+        assert(v.Capacity() == SIZE * 2);
+    }
+    {
+        Obj::ResetCounters();
+        Vector<Obj> v(SIZE, DEFAULT_INIT);
+        assert(Obj::num_default_constructed == SIZE);
+        v.ResizeUninitialized(SIZE + 1);
+        assert(Obj::num_default_constructed == SIZE + 1);
+    }
+    assert(Obj::GetAliveObjectCount() == 0);
+}
+
+void Test16()
+{
+    struct StatsTag;
+    using Stats = CountingStats<StatsTag>;
+    // Конструктор перемещения может выбросить исключение, поэтому при росте элементы копируются
+    struct MayThrowOnMove
+    {
+        MayThrowOnMove() = default;
+        MayThrowOnMove(const MayThrowOnMove &) = default;
+        MayThrowOnMove(MayThrowOnMove &&other) noexcept(false)
+            : value(other.value) //
+        {
+        }
+        MayThrowOnMove &operator=(const MayThrowOnMove &) = default;
+        int value = 0;
+    };
+    {
+        Stats::Reset();
+        Vector<Obj, std::allocator<Obj>, DoublingGrowth, Stats> v;
+        for (int i = 0; i < 5; ++i)
+        {
+            v.EmplaceBack(i);
+        }
+        v.Reserve(20);
+        // Емкости 1, 2, 4, 8, 20
+        const VectorStatsSnapshot snapshot = Stats::Snapshot();
+        assert(snapshot.allocations == 5);
+        assert(snapshot.allocated_bytes == (1 + 2 + 4 + 8 + 20) * sizeof(Obj));
+        assert(snapshot.reallocations == 4);
+        assert(snapshot.moved_elements == 1 + 2 + 4 + 5);
+        assert(snapshot.copied_elements == 0);
+        assert(snapshot.relocated_bytes == snapshot.moved_elements * sizeof(Obj));
+        assert(snapshot.peak_capacity == 20);
+    }
+    {
+        Stats::Reset();
+        Vector<MayThrowOnMove, std::allocator<MayThrowOnMove>, DoublingGrowth, Stats> v(3);
+        v.PushBack(MayThrowOnMove{});
+        v.Insert(v.cbegin(), 5, MayThrowOnMove{});
+        const VectorStatsSnapshot snapshot = Stats::Snapshot();
+        assert(snapshot.reallocations == 2);
+        assert(snapshot.moved_elements == 0);
+        assert(snapshot.copied_elements == 3 + 4);
+        assert(snapshot.peak_capacity == 12);
+    }
+    {
+        Stats::Reset();
+        Vector<int, ExpandingAllocator<int>, DoublingGrowth, Stats> v(4);
+        v.Reserve(8);
+        // Расширение на месте не считается реаллокацией
+        const VectorStatsSnapshot snapshot = Stats::Snapshot();
+        assert(snapshot.allocations == 2);
+        assert(snapshot.allocated_bytes == 8 * sizeof(int));
+        assert(snapshot.reallocations == 0);
+        assert(snapshot.peak_capacity == 8);
+    }
+}
+
+void Test17()
+{
+    const size_t SIZE = 100;
+    {
+        Obj::ResetCounters();
+        Vector<Obj> v(SIZE);
+        v.Resize(SIZE / 2);
+        v[0].id = 1;
+        v.ShrinkToFit();
+        assert(v.Size() == SIZE / 2);
+        assert(v.Capacity() == SIZE / 2);
+        assert(v[0].id == 1);
+        assert(Obj::num_moved == SIZE / 2);
+        assert(Obj::GetAliveObjectCount() == SIZE / 2);
+        v.ShrinkToFit();
+        assert(Obj::num_moved == SIZE / 2);
+
+        v.Clear();
+        assert(v.Size() == 0);
+        assert(v.Capacity() == SIZE / 2);
+        assert(Obj::GetAliveObjectCount() == 0);
+        v.ShrinkToFit();
+        assert(v.Capacity() == 0);
+    }
+    {
+        Obj::ResetCounters();
+        Vector<Obj> v(SIZE);
+        v.PopBack();
+        v.Release();
+        assert(v.Size() == 0);
+        assert(v.Capacity() == 0);
+        assert(Obj::GetAliveObjectCount() == 0);
+        v.PushBack(Obj{1});
+        assert(v.Size() == 1);
+    }
+    {
+        Vector<int, MallocAllocator<int>> v(SIZE);
+        v[SIZE / 4 - 1] = 42;
+        v.Resize(SIZE / 4);
+        v.ShrinkToFit();
+        assert(v.Capacity() == SIZE / 4);
+        assert(v[SIZE / 4 - 1] == 42);
+        v.Clear();
+        v.ShrinkToFit();
+        assert(v.Capacity() == 0);
+    }
+}
+
+void Test18()
+{
+    struct alignas(64) CacheLine
+    {
+        int value = 0;
+    };
+    const auto is_aligned = [](const void *p, size_t alignment)
+    {
+        return reinterpret_cast<uintptr_t>(p) % alignment == 0;
+    };
+    {
+        // Типы с повышенным выравниванием выравниваются и стандартным аллокатором
+        Vector<CacheLine> v;
+        for (int i = 0; i < 10; ++i)
+        {
+            v.PushBack(CacheLine{i});
+            assert(is_aligned(v.begin(), alignof(CacheLine)));
+        }
+    }
+    {
+        AlignedVector<float, 64> v;
+        for (int i = 0; i < 100; ++i)
+        {
+            v.PushBack(static_cast<float>(i));
+            assert(is_aligned(v.begin(), 64));
+        }
+        v.ShrinkToFit();
+        assert(is_aligned(v.begin(), 64));
+        assert(v[99] == 99.0f);
+        const AlignedVector<float, 64> v_copy(v);
+        assert(is_aligned(v_copy.begin(), 64));
+    }
+    {
+        Vector<double, AlignedAllocator<double, 32>> v(7);
+        assert(is_aligned(v.begin(), 32));
+    }
+}
+
+template <typename T>
+void TestSimdFor(const Vector<T> &v)
+{
+    const T needle = v[v.Size() / 2];
+    assert(simd::Count(v, needle) == static_cast<size_t>(std::count(v.begin(), v.end(), needle)));
+    assert(simd::Find(v, needle) == std::find(v.begin(), v.end(), needle));
+    assert(simd::Find(v, T(1000)) == v.end());
+    const auto [min, max] = std::minmax_element(v.begin(), v.end());
+    assert(simd::MinMax(v) == std::make_pair(*min, *max));
+    assert(simd::Sum(v) == simd_detail::SumScalar(v.begin(), v.Size()));
+#if defined(VECTOR_SIMD_X86)
+    if constexpr (simd_detail::HAS_KERNELS<T>)
+    {
+        assert(simd_detail::Sse2::Count(v.begin(), v.Size(), needle) == simd::Count(v, needle));
+        assert(simd_detail::Sse2::Find(v.begin(), v.Size(), needle) ==
+               static_cast<size_t>(simd::Find(v, needle) - v.begin()));
+        assert(simd_detail::Sse2::Sum(v.begin(), v.Size()) == simd::Sum(v));
+    }
+#endif
+
+    // Fill и Transform сверяются с std::fill и std::transform
+    Vector<T> filled(v);
+    simd::Fill(filled, needle);
+    Vector<T> expected(v);
+    std::fill(expected.begin(), expected.end(), needle);
+    assert(std::equal(filled.begin(), filled.end(), expected.begin()));
+
+    const auto op = [](T x)
+    {
+        return x * 3 - 1;
+    };
+    Vector<T> transformed;
+    simd::Transform(v, transformed, op);
+    std::transform(v.begin(), v.end(), expected.begin(), op);
+    assert(transformed.Size() == v.Size() && std::equal(transformed.begin(), transformed.end(), expected.begin()));
+    Vector<T> in_place(v);
+    simd::Transform(in_place, in_place, op);
+    assert(std::equal(in_place.begin(), in_place.end(), expected.begin()));
+#if defined(VECTOR_SIMD_X86)
+    if constexpr (simd_detail::HAS_KERNELS<T>)
+    {
+        Vector<T> sse2(v);
+        simd_detail::Sse2::Fill(sse2.Data(), sse2.Size(), needle);
+        assert(std::count(sse2.begin(), sse2.end(), needle) == static_cast<std::ptrdiff_t>(sse2.Size()));
+        simd_detail::Sse2::Transform(v.Data(), sse2.Data(), v.Size(), op);
+        assert(std::equal(sse2.begin(), sse2.end(), expected.begin()));
+    }
+#endif
+}
+
+void Test19()
+{
+    for (size_t size : {1, 3, 8, 17, 100, 1003})
+    {
+        Vector<int32_t> ints(size);
+        Vector<float> floats(size);
+        Vector<double> doubles(size);
+        for (size_t i = 0; i < size; ++i)
+        {
+            // Небольшие целые значения: суммы float и double точны при любом порядке сложения
+            const int value = static_cast<int>((i * 7919) % 1000) - 500;
+            ints[i] = value;
+            floats[i] = static_cast<float>(value);
+            doubles[i] = value;
+        }
+        TestSimdFor(ints);
+        TestSimdFor(floats);
+        TestSimdFor(doubles);
+    }
+    {
+        Vector<int32_t> v(1000);
+        std::fill(v.begin(), v.end(), 3);
+        assert(simd::Count(v, 3) == 1000);
+        assert(simd::Sum(v) == 3000);
+        v[999] = std::numeric_limits<int32_t>::max();
+        // Переполнение заворачивается
+        assert(simd::Sum(v) == static_cast<int32_t>(2997u + static_cast<uint32_t>(std::numeric_limits<int32_t>::max())));
+
+        Vector<int32_t> copy(v);
+        assert(simd::Equal(v, copy));
+        copy[500] = 0;
+        assert(!simd::Equal(v, copy));
+        copy.PopBack();
+        assert(!simd::Equal(v, copy));
+
+        Vector<float> nan(1);
+        nan[0] = std::numeric_limits<float>::quiet_NaN();
+        assert(!simd::Equal(nan, nan));
+    }
+}
+
+void Test20()
+{
+    struct Vec2
+    {
+        float x = 0;
+        float y = 0;
+    };
+    {
+        SoAVector<Vec2, float, int> particles;
+        // Пустой диапазон в пустом контейнере не трогает столбцы без буферов
+        particles.Erase(0, 0);
+        assert(particles.Size() == 0);
+        for (int i = 0; i < 100; ++i)
+        {
+            particles.EmplaceBack(Vec2{float(i), 0}, i * 0.5f, i);
+        }
+        assert(particles.Size() == 100);
+        assert(particles.Capacity() >= 100);
+
+        // Столбец лежит подряд и пригоден для векторизованных циклов
+        ColumnSpan<float> masses = particles.Column<1>();
+        assert(masses.Size() == 100);
+        assert(masses.Data() + 99 == &particles.Get<1>(99));
+        float total = 0;
+        for (float mass : masses)
+        {
+            total += mass;
+        }
+        assert(total == 0.5f * 99 * 100 / 2);
+
+        // Строка — кортеж ссылок на поля
+        auto [position, mass, id] = particles[10];
+        assert(position.x == 10.0f && mass == 5.0f && id == 10);
+        id = 1000;
+        assert(particles.Get<2>(10) == 1000);
+
+        int rows = 0;
+        for (auto [p, m, row_id] : particles)
+        {
+            p.y = m;
+            (void)row_id;
+            ++rows;
+        }
+        assert(rows == 100);
+        assert(particles.Get<0>(7).y == 3.5f);
+
+        particles.Erase(0, 10);
+        assert(particles.Size() == 90);
+        assert(particles.Get<2>(0) == 1000);
+        particles.Erase(0);
+        assert(particles.Get<2>(0) == 11 && particles.Get<0>(0).x == 11.0f);
+        particles.PopBack();
+        assert(particles.Size() == 88 && particles.Get<2>(87) == 98);
+
+        const SoAVector<Vec2, float, int> copy(particles);
+        assert(copy.Size() == particles.Size());
+        assert(std::get<2>(copy[5]) == particles.Get<2>(5));
+        SoAVector<Vec2, float, int> moved(std::move(particles));
+        assert(moved.Size() == 88 && particles.Size() == 0);
+    }
+    {
+        Obj::ResetCounters();
+        SoAVector<std::string, Obj> rows;
+        rows.Reserve(4);
+        for (int i = 0; i < 4; ++i)
+        {
+            rows.EmplaceBack(std::to_string(i), i);
+        }
+        assert(rows.Size() == rows.Capacity());
+
+        Obj bad;
+        bad.throw_on_copy = true;
+        const size_t capacity = rows.Capacity();
+        const int alive = Obj::GetAliveObjectCount();
+        try
+        {
+            // Строка не создана, контейнер не изменился
+            rows.EmplaceBack("bad", bad);
+            assert(false);
+        }
+        catch (const std::runtime_error &)
+        {
+        }
+        assert(rows.Size() == 4 && rows.Capacity() == capacity);
+        assert(Obj::GetAliveObjectCount() == alive);
+        for (int i = 0; i < 4; ++i)
+        {
+            assert(rows.Get<0>(i) == std::to_string(i) && rows.Get<1>(i).id == i);
+        }
+
+        rows.EmplaceBack("four", 4);
+        assert(rows.Size() == 5 && rows.Capacity() > capacity);
+        assert(rows.Get<0>(4) == "four" && rows.Get<1>(2).id == 2);
+        rows.Erase(1);
+        assert(rows.Get<0>(1) == "2" && rows.Get<1>(1).id == 2);
+        rows.Clear();
+        assert(Obj::GetAliveObjectCount() == 1);
+    }
+}
+
+void Test21()
+{
+    struct Record
+    {
+        uint64_t id;
+        double value;
+    };
+    const std::string path = "mapped_vector_test.bin";
+    std::remove(path.c_str());
+    {
+        MappedVector<Record> records = OpenMappedVector<Record>(path);
+        assert(records.Size() == 0 && records.GetAllocator().File() != nullptr);
+        for (uint64_t i = 0; i < 10000; ++i)
+        {
+            records.PushBack({i, i * 0.5});
+        }
+        records.Insert(records.begin() + 1, 2, Record{42, 4.2});
+        records.Erase(records.begin() + 1, records.begin() + 3);
+        SyncMappedVector(records);
+
+        // Копия не пишет в файл
+        MappedVector<Record> copy(records);
+        assert(copy.GetAllocator().File() == nullptr);
+        copy[0].id = 100500;
+        for (uint64_t i = 0; i < 1000; ++i)
+        {
+            copy.PushBack({i, 0});
+        }
+        assert(records[0].id == 0);
+
+        // Несинхронизированные элементы не попадают в сохраненный размер
+        records.PushBack({1, 1});
+    }
+    {
+        MappedVector<Record> records = OpenMappedVector<Record>(path);
+        assert(records.Size() == 10000);
+        assert(records.Capacity() >= records.Size());
+        for (uint64_t i = 0; i < records.Size(); ++i)
+        {
+            assert(records[i].id == i && records[i].value == i * 0.5);
+        }
+        // Параллельный Reserve переносит буфер через mremap, а второй буфер того же файла не выделяется
+        records.Reserve(20000, PARALLEL);
+        assert(records.Capacity() == 20000 && records[9999].id == 9999);
+        MappedFileAllocator<Record> alloc = records.GetAllocator();
+        try
+        {
+            alloc.allocate(1);
+            assert(false);
+        }
+        catch (const std::logic_error &)
+        {
+        }
+        assert(records[0].id == 0);
+
+        records.Resize(5000);
+        records.ShrinkToFit();
+        assert(records.Capacity() == 5000);
+        SyncMappedVector(records);
+    }
+    {
+        const MappedVector<Record> records = OpenMappedVector<Record>(path);
+        assert(records.Size() == 5000 && records.Capacity() == 5000);
+        assert(records[4999].id == 4999);
+    }
+    {
+        std::ofstream(path, std::ios::binary | std::ios::trunc) << std::string(MappedFile::HEADER_SIZE, 'x');
+        try
+        {
+            OpenMappedVector<Record>(path);
+            assert(false);
+        }
+        catch (const std::runtime_error &)
+        {
+        }
+
+        // Файл короче заголовка отклоняется и остается нетронутым
+        std::ofstream(path, std::ios::binary | std::ios::trunc) << "not ours";
+        try
+        {
+            OpenMappedVector<Record>(path);
+            assert(false);
+        }
+        catch (const std::runtime_error &)
+        {
+        }
+        std::ifstream in(path, std::ios::binary);
+        const std::string contents((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+        assert(contents == "not ours");
+    }
+    std::remove(path.c_str());
+}
+
+void Test22()
+{
+    {
+        std::allocator<std::string> alloc;
+        std::string *buffer = alloc.allocate(4);
+        new (buffer) std::string("a");
+        new (buffer + 1) std::string("b");
+        Vector<std::string> v = Vector<std::string>::Adopt(buffer, 2, 4);
+        assert(v.Size() == 2 && v.Capacity() == 4 && v.begin() == buffer);
+        v.PushBack("c");
+        assert(v.begin() == buffer && v[2] == "c");
+
+        DetachedBuffer<std::string, std::allocator<std::string>> detached = v.Detach();
+        assert(v.Size() == 0 && v.Capacity() == 0 && v.begin() == nullptr);
+        assert(detached.data == buffer && detached.size == 3 && detached.capacity == 4);
+        // Отданный буфер можно снова передать вектору
+        Vector<std::string> back = Vector<std::string>::Adopt(detached.data, detached.size, detached.capacity,
+                                                              detached.allocator);
+        assert(back[0] == "a" && back[2] == "c");
+    }
+    {
+        int deleted = 0;
+        const auto deleter = [&deleted](int *p)
+        {
+            std::free(p);
+            ++deleted;
+        };
+        using ExternalVector = Vector<int, ExternalBufferAllocator<int>>;
+        {
+            int *buffer = static_cast<int *>(std::malloc(3 * sizeof(int)));
+            buffer[0] = 1;
+            buffer[1] = 2;
+            ExternalVector v = ExternalVector::Adopt(buffer, 2, 3, deleter);
+            v.PushBack(3);
+            assert(deleted == 0);
+            // При росте внешний буфер освобождается его собственным deleter
+            v.PushBack(4);
+            assert(deleted == 1);
+            assert(v.Size() == 4 && v[0] == 1 && v[3] == 4);
+
+            ExternalVector copy(v);
+            assert(copy[2] == 3);
+        }
+        assert(deleted == 1);
+        {
+            int *buffer = static_cast<int *>(std::malloc(sizeof(int)));
+            *buffer = 7;
+            ExternalVector v = ExternalVector::Adopt(buffer, 1, 1, deleter);
+            ExternalVector moved(std::move(v));
+            assert(moved[0] == 7);
+        }
+        assert(deleted == 2);
+        {
+            // Аллокаторы разных внешних буферов не равны: буфер уходит вместе со своим аллокатором
+            int *first = static_cast<int *>(std::malloc(2 * sizeof(int)));
+            int *second = static_cast<int *>(std::malloc(2 * sizeof(int)));
+            first[0] = 1;
+            second[0] = 2;
+            ExternalVector lhs = ExternalVector::Adopt(first, 1, 2, deleter);
+            ExternalVector rhs = ExternalVector::Adopt(second, 1, 2, deleter);
+            assert(lhs.GetAllocator() != rhs.GetAllocator());
+            assert(ExternalBufferAllocator<int>() == ExternalBufferAllocator<int>());
+            lhs = std::move(rhs);
+            assert(lhs.Data() == second && lhs[0] == 2);
+
+            ExternalVector other(3);
+            other.Swap(lhs);
+            assert(other.Data() == second && lhs.Size() == 3);
+        }
+        assert(deleted == 4);
+    }
+    {
+        // Буфер MallocAllocator можно отдать коду на C, который освободит его через free
+        Vector<int, MallocAllocator<int>> v(100);
+        v[99] = 99;
+        DetachedBuffer<int, MallocAllocator<int>> detached = v.Detach();
+        assert(detached.data[99] == 99);
+        std::free(detached.data);
+    }
+}
+
+void Test23()
+{
+    struct StatsTag;
+    using Stats = CountingStats<StatsTag>;
+    {
+        // Больше одного блока чтения
+        Vector<int> v(100000);
+        for (size_t i = 0; i < v.Size(); ++i)
+        {
+            v[i] = static_cast<int>(i * 3);
+        }
+        std::stringstream stream;
+        Serialize(v, stream);
+        assert(stream.str().size() == sizeof(SerializedVectorHeader) + v.Size() * sizeof(int));
+
+        Stats::Reset();
+        Vector<int, std::allocator<int>, DoublingGrowth, Stats> restored;
+        Deserialize(stream, restored);
+        assert(Stats::Snapshot().allocations == 1);
+        assert(restored.Size() == v.Size());
+        assert(std::equal(v.begin(), v.end(), restored.begin()));
+    }
+    {
+        std::stringstream stream;
+        Serialize(Vector<double>(), stream);
+        assert(Deserialize<double>(stream).Size() == 0);
+    }
+    {
+        Vector<Vector<std::string>> v;
+        v.EmplaceBack();
+        v[0].PushBack("first");
+        v[0].PushBack("");
+        v.EmplaceBack();
+        v[1].PushBack(std::string(1000, 'x'));
+        std::stringstream stream;
+        Serialize(v, stream);
+        const Vector<Vector<std::string>> restored = Deserialize<Vector<std::string>>(stream);
+        assert(restored.Size() == 2);
+        assert(restored[0].Size() == 2 && restored[0][0] == "first" && restored[0][1].empty());
+        assert(restored[1][0] == v[1][0]);
+    }
+    {
+        Vector<int> v(10);
+        std::stringstream stream;
+        Serialize(v, stream);
+        const std::string data = stream.str();
+
+        Vector<int> target(3);
+        target[2] = 42;
+        const auto expect_failure = [&target](const std::string &bytes)
+        {
+            std::istringstream in(bytes);
+            try
+            {
+                Deserialize(in, target);
+                assert(false);
+            }
+            catch (const std::runtime_error &)
+            {
+            }
+            // При ошибке вектор не изменяется
+            assert(target.Size() == 3 && target[2] == 42);
+        };
+        expect_failure(data.substr(0, data.size() - 1));
+        expect_failure(data.substr(0, 4));
+        expect_failure("x" + data.substr(1));
+
+        std::istringstream in(data);
+        try
+        {
+            Deserialize<double>(in);
+            assert(false);
+        }
+        catch (const std::runtime_error &)
+        {
+        }
+    }
+    {
+        // Поток без позиционирования: остаток неизвестен, и буфер растет по мере чтения
+        struct ForwardOnlyBuffer : std::streambuf
+        {
+            explicit ForwardOnlyBuffer(std::string &bytes)
+            {
+                setg(bytes.data(), bytes.data(), bytes.data() + bytes.size());
+            }
+        };
+
+        Vector<int> v(100000);
+        std::iota(v.begin(), v.end(), 0);
+        std::stringstream stream;
+        Serialize(v, stream);
+        std::string data = stream.str();
+        {
+            ForwardOnlyBuffer buffer(data);
+            std::istream in(&buffer);
+            const Vector<int> restored = Deserialize<int>(in);
+            assert(restored.Size() == v.Size() && std::equal(v.begin(), v.end(), restored.begin()));
+        }
+        {
+            // Число выделений растет логарифмически: 1'000'000 элементов — это 62 блока чтения
+            Vector<int> big(1000000);
+            std::iota(big.begin(), big.end(), 0);
+            std::stringstream big_stream;
+            Serialize(big, big_stream);
+            std::string big_data = big_stream.str();
+            ForwardOnlyBuffer buffer(big_data);
+            std::istream in(&buffer);
+            Stats::Reset();
+            Vector<int, std::allocator<int>, DoublingGrowth, Stats> restored;
+            Deserialize(in, restored);
+            assert(restored.Size() == big.Size() && std::equal(big.begin(), big.end(), restored.begin()));
+            assert(Stats::Snapshot().allocations <= 7);
+        }
+
+        // Огромный размер в заголовке при коротких данных: ошибка формата, а не нехватка памяти
+        SerializedVectorHeader header;
+        header.element_size = sizeof(int);
+        header.size = uint64_t(1) << 40;
+        std::string corrupt(reinterpret_cast<const char *>(&header), sizeof(header));
+        corrupt += data.substr(sizeof(header), 1000);
+        const auto expect_failure = [](std::istream &in)
+        {
+            try
+            {
+                Deserialize<int>(in);
+                assert(false);
+            }
+            catch (const std::runtime_error &)
+            {
+            }
+        };
+        std::istringstream seekable(corrupt);
+        expect_failure(seekable);
+        ForwardOnlyBuffer buffer(corrupt);
+        std::istream forward_only(&buffer);
+        expect_failure(forward_only);
+
+        header.size = std::numeric_limits<uint64_t>::max();
+        std::istringstream too_long(std::string(reinterpret_cast<const char *>(&header), sizeof(header)));
+        expect_failure(too_long);
+
+        // То же для длины строки
+        std::stringstream strings;
+        Vector<std::string> words;
+        words.PushBack("abc");
+        Serialize(words, strings);
+        std::string bad_string = strings.str();
+        const uint64_t huge_length = uint64_t(1) << 40;
+        bad_string.replace(sizeof(header), sizeof(huge_length), reinterpret_cast<const char *>(&huge_length),
+                           sizeof(huge_length));
+        std::istringstream string_in(bad_string);
+        try
+        {
+            Deserialize<std::string>(string_in);
+            assert(false);
+        }
+        catch (const std::runtime_error &)
+        {
+        }
+    }
+}
+
+void Test24()
+{
+    {
+        ConcurrentVector<std::string, std::allocator<std::string>, 4> v;
+        const std::string &first = v.EmplaceBack("first");
+        for (int i = 0; i < 1000; ++i)
+        {
+            v.PushBack(std::to_string(i));
+        }
+        // Рост не перемещает элементы
+        assert(&first == &v[0] && first == "first");
+        assert(v.Size() == 1001 && v[1000] == "999" && v[4] == "3");
+    }
+    {
+        Obj::ResetCounters();
+        {
+            ConcurrentVector<Obj> v;
+            v.EmplaceBack(1);
+            Obj::default_construction_throw_countdown = 1;
+            try
+            {
+                v.EmplaceBack();
+                assert(false);
+            }
+            catch (const std::runtime_error &)
+            {
+            }
+            assert(v.Size() == 1);
+            v.EmplaceBack(2);
+            assert(v.Size() == 2 && v[1].id == 2);
+        }
+        assert(Obj::GetAliveObjectCount() == 0);
+    }
+    {
+        const int THREADS = 8;
+        const int PER_THREAD = 20000;
+        ConcurrentVector<std::pair<int, int>> v;
+        std::atomic<bool> done{false};
+        std::thread reader([&v, &done]
+                           {
+                               // Все элементы до Size() уже созданы
+                               while (!done.load())
+                               {
+                                   const size_t size = v.Size();
+                                   if (size > 0)
+                                   {
+                                       const std::pair<int, int> &last = v[size - 1];
+                                       assert(last.first >= 0 && last.first < THREADS);
+                                       assert(last.second >= 0 && last.second < PER_THREAD);
+                                   }
+                               } });
+        std::vector<std::thread> producers;
+        for (int t = 0; t < THREADS; ++t)
+        {
+            producers.emplace_back([&v, t]
+                                   {
+                                       for (int i = 0; i < PER_THREAD; ++i)
+                                       {
+                                           v.EmplaceBack(t, i);
+                                       } });
+        }
+        for (std::thread &producer : producers)
+        {
+            producer.join();
+        }
+        done = true;
+        reader.join();
+
+        assert(v.Size() == size_t(THREADS * PER_THREAD));
+        // Элементы каждого производителя идут в порядке добавления
+        std::vector<int> next(THREADS, 0);
+        for (size_t i = 0; i < v.Size(); ++i)
+        {
+            assert(v[i].second == next[v[i].first]++);
+        }
+    }
+    {
+        // Элемент, конструктор которого ждет разрешения, уже занимает свою позицию
+        struct Gate
+        {
+            Gate(std::atomic<bool> &started, const std::atomic<bool> &release, int id) noexcept
+                : id(id)
+            {
+                started = true;
+                while (!release.load())
+                {
+                    std::this_thread::yield();
+                }
+            }
+
+            explicit Gate(int id) noexcept
+                : id(id)
+            {
+            }
+
+            int id;
+        };
+
+        ConcurrentVector<Gate> v;
+        std::atomic<bool> started{false};
+        std::atomic<bool> release{false};
+        std::thread slow([&]
+                         { v.EmplaceBack(started, release, 0); });
+        while (!started.load())
+        {
+            std::this_thread::yield();
+        }
+        // Следующий производитель не ждет медленного, но Size() не растет, пока позиция 0 не готова
+        const Gate &fast = v.EmplaceBack(1);
+        assert(fast.id == 1 && v.Size() == 0);
+        release = true;
+        slow.join();
+        assert(v.Size() == 2 && v[0].id == 0 && &v[1] == &fast);
+    }
+}
+
+void Test25()
+{
+    // Больше, чем обрабатывается в одном потоке
+    const size_t SIZE = 4 * (1 << 20) / sizeof(Counted) + 123;
+    const ParallelTag FOUR_THREADS(4);
+    {
+        Vector<int> v(SIZE, FOUR_THREADS);
+        assert(v.Size() == SIZE && std::count(v.begin(), v.end(), 0) == static_cast<int>(SIZE));
+        for (size_t i = 0; i < SIZE; ++i)
+        {
+            v[i] = static_cast<int>(i);
+        }
+        const Vector<int> copy(v, PARALLEL);
+        assert(std::equal(v.begin(), v.end(), copy.begin()));
+        v.Reserve(SIZE * 2, FOUR_THREADS);
+        assert(v.Capacity() == SIZE * 2 && std::equal(v.begin(), v.end(), copy.begin()));
+    }
+    {
+        Vector<std::string> v(SIZE / 8, FOUR_THREADS);
+        v[100] = "hundred";
+        v.Reserve(v.Size() * 2, FOUR_THREADS);
+        assert(v[100] == "hundred");
+        Vector<std::string> copy(v, FOUR_THREADS);
+        v.Release(FOUR_THREADS);
+        assert(v.Size() == 0 && v.Capacity() == 0 && copy[100] == "hundred");
+    }
+    {
+        Vector<Counted> v(SIZE, FOUR_THREADS);
+        assert(Counted::alive == static_cast<int>(SIZE));
+        v[SIZE * 3 / 4].value = Counted::THROW_ON_COPY;
+        try
+        {
+            Vector<Counted> copy(v, FOUR_THREADS);
+            assert(false);
+        }
+        catch (const std::runtime_error &)
+        {
+        }
+        // Копии из успешно скопированных частей уничтожены
+        assert(Counted::alive == static_cast<int>(SIZE));
+
+        const size_t capacity = v.Capacity();
+        try
+        {
+            v.Reserve(SIZE * 2, FOUR_THREADS);
+            assert(false);
+        }
+        catch (const std::runtime_error &)
+        {
+        }
+        assert(v.Capacity() == capacity && v.Size() == SIZE);
+        assert(Counted::alive == static_cast<int>(SIZE));
+
+        v[SIZE * 3 / 4].value = 0;
+        v.Reserve(SIZE * 2, FOUR_THREADS);
+        assert(v.Capacity() == SIZE * 2 && Counted::alive == static_cast<int>(SIZE));
+        v.Clear(FOUR_THREADS);
+        assert(Counted::alive == 0);
+    }
+}
+
+void Test26()
+{
+    {
+        SegmentedVector<int, std::allocator<int>, 8> v;
+        v.PushBack(0);
+        const int *first = &v[0];
+        for (int i = 1; i < 100; ++i)
+        {
+            v.PushBack(i);
+        }
+        // Рост не перемещает элементы
+        assert(first == &v[0]);
+        assert(v.Size() == 100 && v.Capacity() == 104);
+        assert(v.SegmentCount() == 13 && v.Segment(12).Size() == 4);
+
+        int expected = 0;
+        size_t segments = 0;
+        for (Span<int> segment : v.Segments())
+        {
+            assert(segments + 1 == v.SegmentCount() || segment.Size() == 8);
+            for (int value : segment)
+            {
+                assert(value == expected++);
+            }
+            ++segments;
+        }
+        assert(segments == 13 && expected == 100);
+
+        SegmentedVector<int, std::allocator<int>, 8>::const_iterator it = v.begin() + 50;
+        assert(*it == 50 && it[10] == 60 && v.end() - it == 50);
+        assert(std::accumulate(v.begin(), v.end(), 0) == 99 * 100 / 2);
+        assert(*std::lower_bound(v.begin(), v.end(), 77) == 77);
+
+        v.Resize(20);
+        v.ShrinkToFit();
+        assert(v.Size() == 20 && v.Capacity() == 24 && first == &v[0]);
+        v.Reserve(100);
+        assert(v.Capacity() == 104);
+    }
+    {
+        Obj::ResetCounters();
+        {
+            SegmentedVector<Obj, std::allocator<Obj>, 4> v;
+            for (int i = 0; i < 4; ++i)
+            {
+                v.EmplaceBack(i);
+            }
+            // Аргумент ссылается на элемент вектора
+            v.PushBack(v[0]);
+            assert(v[4].id == 0 && Obj::num_moved == 0);
+
+            Obj::default_construction_throw_countdown = 1;
+            try
+            {
+                v.EmplaceBack();
+                assert(false);
+            }
+            catch (const std::runtime_error &)
+            {
+            }
+            assert(v.Size() == 5);
+
+            SegmentedVector<Obj, std::allocator<Obj>, 4> copy(v);
+            assert(copy.Size() == 5 && copy[3].id == 3);
+            SegmentedVector<Obj, std::allocator<Obj>, 4> moved(std::move(copy));
+            assert(moved.Size() == 5 && copy.Size() == 0);
+            copy = moved;
+            assert(copy.Size() == 5);
+        }
+        assert(Obj::GetAliveObjectCount() == 0);
+    }
+    static_assert(SegmentedVector<int>::BLOCK_CAPACITY == 1024);
+}
+
+void Test27()
+{
+    const size_t STEP = 16;
+    {
+        Obj::ResetCounters();
+        {
+            IncrementalVector<Obj, std::allocator<Obj>, DoublingGrowth, STEP> v;
+            int max_moved_per_push = 0;
+            for (int i = 0; i < 5000; ++i)
+            {
+                const int moved_before = Obj::num_moved;
+                v.EmplaceBack(i);
+                max_moved_per_push = std::max(max_moved_per_push, Obj::num_moved - moved_before);
+                if (i % 97 == 0)
+                {
+                    for (int j = 0; j <= i; j += 13)
+                    {
+                        assert(v[j].id == j);
+                    }
+                }
+            }
+            // При удвоении емкости хватает минимальной порции
+            assert(max_moved_per_push <= static_cast<int>(STEP));
+            assert(v.Size() == 5000 && !v.IsMigrating());
+
+            // Рост до 8192: перенос начался, но не закончился
+            for (int i = 5000; i < 8200; ++i)
+            {
+                v.EmplaceBack(i);
+            }
+            assert(v.IsMigrating() && v.Capacity() == 8192 * 2);
+            const IncrementalVector<Obj, std::allocator<Obj>, DoublingGrowth, STEP> copy(v);
+            assert(copy.Size() == v.Size() && copy[4000].id == 4000);
+
+            // Константный вектор обходится по обоим буферам, перенос не завершается
+            const auto &view = v;
+            int next_id = 0;
+            for (const Obj &obj : view)
+            {
+                assert(obj.id == next_id++);
+            }
+            assert(next_id == 8200 && v.IsMigrating());
+            assert(std::distance(view.cbegin(), view.cend()) == 8200);
+
+            // Удаляем элементы из нового буфера, затем и из старого
+            while (v.Size() > 100)
+            {
+                v.PopBack();
+            }
+            assert(!v.IsMigrating());
+            assert(v[99].id == 99);
+            int expected = 0;
+            for (const Obj &obj : v)
+            {
+                assert(obj.id == expected++);
+            }
+
+            Obj::default_construction_throw_countdown = 1;
+            try
+            {
+                v.EmplaceBack();
+                assert(false);
+            }
+            catch (const std::runtime_error &)
+            {
+            }
+            assert(v.Size() == 100);
+        }
+        assert(Obj::GetAliveObjectCount() == 0);
+    }
+    {
+        // Рост в 1.5 раза: порция увеличивается, чтобы перенос успел завершиться
+        IncrementalVector<int, std::allocator<int>, OneAndHalfGrowth, 1> v;
+        for (int i = 0; i < 100000; ++i)
+        {
+            v.PushBack(i);
+        }
+        v.PushBack(v[0]);
+        assert(v[100000] == 0 && v[54321] == 54321);
+        v.Reserve(1 << 20);
+        assert(v.Capacity() == (1 << 20) && v.IsMigrating());
+        v.FinishMigration();
+        assert(!v.IsMigrating() && v[99999] == 99999);
+    }
+}
+
+void Test28()
+{
+    using Cow = CowVector<Obj, std::allocator<Obj>, 4>;
+    Obj::ResetCounters();
+    {
+        Cow v;
+        for (int i = 0; i < 10; ++i)
+        {
+            v.EmplaceBack(i);
+        }
+        const Cow snapshot(v);
+        assert(v.IsShared() && snapshot.IsShared());
+        assert(Obj::num_copied == 0 && &snapshot[5] == &v[5]);
+
+        // Копируется только последний блок из двух элементов
+        v.EmplaceBack(10);
+        assert(Obj::num_copied == 2);
+        assert(v.Size() == 11 && snapshot.Size() == 10 && v[10].id == 10);
+        assert(&snapshot[5] == &v[5] && &snapshot[9] != &v[9]);
+
+        v.Mutable(5).id = 500;
+        assert(Obj::num_copied == 6);
+        assert(v[5].id == 500 && snapshot[5].id == 5);
+        // Блок уже собственный
+        v.Mutable(6).id = 600;
+        assert(Obj::num_copied == 6);
+
+        Cow other = snapshot;
+        while (other.Size() > 3)
+        {
+            other.PopBack();
+        }
+        assert(snapshot.Size() == 10 && snapshot[9].id == 9 && other[2].id == 2);
+
+        int expected = 0;
+        for (const Obj &obj : snapshot)
+        {
+            assert(obj.id == expected++);
+        }
+        assert(expected == 10);
+    }
+    assert(Obj::GetAliveObjectCount() == 0);
+    {
+        Cow v;
+        v.EmplaceBack(1);
+        v.EmplaceBack(2);
+        v.Mutable(1).throw_on_copy = true;
+        const Cow snapshot(v);
+        try
+        {
+            v.Mutable(0).id = 100;
+            assert(false);
+        }
+        catch (const std::runtime_error &)
+        {
+        }
+        assert(v[0].id == 1 && snapshot[0].id == 1 && v.Size() == 2);
+    }
+    assert(Obj::GetAliveObjectCount() == 0);
+    {
+        // Копия получает аллокатор из select_on_container_copy_construction
+        struct CopyResetAllocator : std::allocator<int>
+        {
+            explicit CopyResetAllocator(int id = 0) noexcept
+                : id(id)
+            {
+            }
+
+            CopyResetAllocator select_on_container_copy_construction() const noexcept
+            {
+                return CopyResetAllocator();
+            }
+
+            int id;
+        };
+        CowVector<int, CopyResetAllocator, 4> v(CopyResetAllocator(5));
+        v.PushBack(1);
+        CowVector<int, CopyResetAllocator, 4> copy(v);
+        assert(v.GetAllocator().id == 5 && copy.GetAllocator().id == 0);
+        copy.Mutable(0) = 2;
+        copy.PushBack(3);
+        assert(v.Size() == 1 && v[0] == 1 && copy[0] == 2 && copy[1] == 3);
+    }
+    {
+        // Снимки читаются в других потоках, пока исходный вектор изменяется
+        CowVector<int> v;
+        for (int i = 0; i < 100000; ++i)
+        {
+            v.PushBack(i);
+        }
+        std::vector<std::thread> readers;
+        for (int t = 0; t < 4; ++t)
+        {
+            readers.emplace_back([snapshot = v]
+                                 {
+                                     long long sum = 0;
+                                     for (int value : snapshot)
+                                     {
+                                         sum += value;
+                                     }
+                                     assert(sum == 99999LL * 100000 / 2);
+                                 });
+        }
+        for (int i = 0; i < 100000; i += 1000)
+        {
+            v.Mutable(i) = -1;
+            v.PushBack(i);
+        }
+        for (std::thread &reader : readers)
+        {
+            reader.join();
+        }
+        assert(v[0] == -1 && v.Size() == 100100);
+    }
+}
+
+void Test29()
+{
+    using IntAlloc = TrackingAllocator<int, false>;
+    using ObjAlloc = TrackingAllocator<Obj, false>;
+    {
+        Vector<int, IntAlloc> big(100, IntAlloc{1});
+        std::iota(big.begin(), big.end(), 0);
+        Vector<int, IntAlloc> small(2, IntAlloc{1});
+        IntAlloc::peak_allocations[1] = IntAlloc::live_allocations[1];
+        // Старый буфер освобождается до выделения нового
+        small = big;
+        assert(IntAlloc::peak_allocations[1] == 2 && IntAlloc::live_allocations[1] == 2);
+        assert(small.Size() == 100 && small[99] == 99);
+
+        // Емкость переиспользуется и не уменьшается
+        Vector<int, IntAlloc> three(3, IntAlloc{1});
+        three[2] = 7;
+        small = three;
+        assert(small.Size() == 3 && small.Capacity() == 100 && small[2] == 7);
+        small.Assign(big, true);
+        assert(small.Capacity() == 100 && small[50] == 50);
+        small.Assign(three, false);
+        assert(small.Size() == 3 && small.Capacity() == 3 && small[2] == 7);
+        small.Assign(small, false);
+        assert(small.Size() == 3);
+    }
+    assert(IntAlloc::live_allocations[1] == 0);
+    Obj::ResetCounters();
+    {
+        Vector<Obj, ObjAlloc> big(10, ObjAlloc{1});
+        Vector<Obj, ObjAlloc> small(2, ObjAlloc{1});
+        ObjAlloc::peak_allocations[1] = ObjAlloc::live_allocations[1];
+        // Для Obj копия строится до освобождения старого буфера (строгая гарантия)
+        small = big;
+        assert(ObjAlloc::peak_allocations[1] == 3 && ObjAlloc::live_allocations[1] == 2);
+        assert(small.Size() == 10);
+
+        Vector<Obj, ObjAlloc> fewer(2, ObjAlloc{1});
+        fewer[1].id = 42;
+        const int old_num_copied = Obj::num_copied;
+        small.Assign(fewer, true);
+        assert(small.Capacity() == 10 && small[1].id == 42 && Obj::num_copied == old_num_copied);
+
+        big[9].throw_on_copy = true;
+        try
+        {
+            fewer = big;
+            assert(false);
+        }
+        catch (const std::runtime_error &)
+        {
+        }
+        assert(fewer.Size() == 2 && fewer.Capacity() == 2 && fewer[1].id == 42);
+    }
+    assert(Obj::GetAliveObjectCount() == 0);
+    assert(ObjAlloc::live_allocations[1] == 0);
+}
+
+void Test30()
+{
+    {
+        PoolAllocator<int> alloc;
+        int *p = alloc.allocate(3);
+        alloc.deallocate(p, 3);
+        // Буфер того же класса размеров берется из списка свободных блоков
+        int *q = alloc.allocate(4);
+        assert(q == p);
+        assert(alloc.try_expand(q, 3, 4) && !alloc.try_expand(q, 4, 5));
+        alloc.deallocate(q, 4);
+
+        int *large = alloc.allocate(PoolAllocator<int>::MAX_BLOCK);
+        large[PoolAllocator<int>::MAX_BLOCK - 1] = 1;
+        alloc.deallocate(large, PoolAllocator<int>::MAX_BLOCK);
+    }
+    Obj::ResetCounters();
+    {
+        PoolVector<Obj> v;
+        for (int i = 0; i < 1000; ++i)
+        {
+            v.EmplaceBack(i);
+        }
+        assert(v.Size() == 1000 && v[999].id == 999);
+        // Емкость совпадает с классом размеров
+        assert((v.Capacity() * sizeof(Obj)) % 16 == 0);
+        PoolVector<Obj> copy(v);
+        v = PoolVector<Obj>();
+        assert(copy[500].id == 500);
+    }
+    assert(Obj::GetAliveObjectCount() == 0);
+    {
+        // Векторы создаются в одних потоках, а освобождаются в других
+        std::vector<PoolVector<int>> results(4);
+        std::vector<std::thread> workers;
+        for (size_t t = 0; t < results.size(); ++t)
+        {
+            workers.emplace_back([&result = results[t], t]
+                                 {
+                                     for (int round = 0; round < 1000; ++round)
+                                     {
+                                         PoolVector<int> v;
+                                         for (int i = 0; i <= round % 100; ++i)
+                                         {
+                                             v.PushBack(i);
+                                         }
+                                         assert(v[round % 100] == round % 100);
+                                     }
+                                     result.Resize(1000 + t);
+                                 });
+        }
+        for (std::thread &worker : workers)
+        {
+            worker.join();
+        }
+        assert(results[3].Size() == 1003);
+    }
+}
+
+void Test31()
+{
+    Obj::ResetCounters();
+    {
+        GapVector<Obj> v;
+        for (int i = 0; i < 100; ++i)
+        {
+            v.EmplaceBack(i);
+        }
+        // Серия вставок рядом с курсором перемещает элементы только при первом переносе
+        v.MoveCursor(50);
+        const int old_num_moved = Obj::num_moved;
+        for (int i = 0; i < 10; ++i)
+        {
+            v.Emplace(50 + i, 1000 + i);
+        }
+        assert(Obj::num_moved == old_num_moved + 10);
+        assert(v.Size() == 110 && v.Cursor() == 60);
+        assert(v[49].id == 49 && v[50].id == 1000 && v[59].id == 1009 && v[60].id == 50 && v[109].id == 99);
+
+        // Удаление перед курсором
+        v.Erase(59);
+        v.Erase(58);
+        assert(v.Size() == 108 && v.Cursor() == 58 && v[57].id == 1007 && v[58].id == 50);
+
+        // Аргумент ссылается на элемент, который перемещается при переносе курсора
+        v.Insert(0, v[107]);
+        assert(v[0].id == 99 && v[1].id == 0 && v.Cursor() == 1);
+
+        int count = 0;
+        for (const Obj &obj : v)
+        {
+            assert(&obj == &v[count]);
+            ++count;
+        }
+        assert(count == 109);
+
+        GapVector<Obj> copy(v);
+        assert(copy.Size() == v.Size() && copy[58].id == v[58].id && copy.Cursor() == copy.Size());
+        v.Erase(10, 100);
+        assert(v.Size() == 19 && v.Cursor() == 10 && v[10].id == 91);
+        v.Clear();
+        assert(v.Size() == 0 && copy.Size() == 109);
+    }
+    assert(Obj::GetAliveObjectCount() == 0);
+    {
+        GapVector<Obj> v;
+        v.EmplaceBack(1);
+        v.EmplaceBack(2);
+        Obj thrower(3);
+        thrower.throw_on_copy = true;
+        try
+        {
+            v.Insert(1, thrower);
+            assert(false);
+        }
+        catch (const std::runtime_error &)
+        {
+        }
+        assert(v.Size() == 2 && v[0].id == 1 && v[1].id == 2);
+    }
+    assert(Obj::GetAliveObjectCount() == 0);
+    {
+        // Рост при каждой позиции промежутка
+        GapVector<std::string> text;
+        const std::vector<std::string> hello = {"h", "e", "l", "l", "o"};
+        text.InsertRange(0, hello.begin(), hello.end());
+        text.InsertRange(0, hello.begin(), hello.begin() + 2);
+        assert(text.Size() == 7 && text.Cursor() == 2);
+        std::string joined;
+        for (const std::string &s : text)
+        {
+            joined += s;
+        }
+        assert(joined == "hehello");
+        for (int i = 0; i < 1000; ++i)
+        {
+            text.Insert(text.Size() / 2, std::to_string(i));
+        }
+        assert(text.Size() == 1007 && text.BeforeCursor().Size() + text.AfterCursor().Size() == text.Size());
+        while (text.Size() > 0)
+        {
+            text.PopBack();
+        }
+        assert(text.Cursor() == 0);
+    }
+}
+
+// Таблица квадратов, вычисляемая на этапе компиляции
+template <size_t N>
+constexpr FixedVector<int, N> MakeSquares()
+{
+    FixedVector<int, N> squares;
+    for (size_t i = 0; i < N; ++i)
+    {
+        squares.PushBack(static_cast<int>(i * i));
+    }
+    return squares;
+}
+
+#if VECTOR_HAS_CONSTEXPR
+constexpr int SumWithVector(int n)
+{
+    Vector<int> v;
+    for (int i = 1; i <= n; ++i)
+    {
+        v.PushBack(i);
+    }
+    Vector<int> copy = v;
+    copy.Resize(n / 2);
+    int sum = 0;
+    for (int x : copy)
+    {
+        sum += x;
+    }
+    return sum + static_cast<int>(v.Size());
+}
+
+constexpr size_t CountWords()
+{
+    Vector<std::string> words;
+    words.EmplaceBack("constexpr");
+    words.EmplaceBack(words[0]);
+    FixedVector<std::string, 4> fixed{"a", "b"};
+    fixed.EmplaceBack(words[1]);
+    fixed.PopBack();
+    return words.Size() + fixed.Size() + words[1].size();
+}
+#endif
+
+void Test32()
+{
+    constexpr auto squares = MakeSquares<16>();
+    static_assert(squares.Size() == 16 && squares[15] == 225);
+    static_assert(FixedVector<int, 3>{1, 2, 3}[2] == 3);
+
+#if VECTOR_HAS_CONSTEXPR
+    static_assert(SumWithVector(10) == 15 + 10);
+    static_assert(CountWords() == 2 + 2 + 9);
+#endif
+
+    {
+        FixedVector<Obj, 4> v;
+        v.EmplaceBack(1);
+        v.PushBack(Obj(2));
+        v.Resize(4);
+        assert(Obj::GetAliveObjectCount() == 4);
+        assert(v[0].id == 1 && v[1].id == 2 && v[3].id == 0);
+
+        FixedVector<Obj, 4> copy = v;
+        assert(Obj::GetAliveObjectCount() == 8);
+        copy.Resize(1);
+        v = copy;
+        assert(v.Size() == 1 && v[0].id == 1 && Obj::GetAliveObjectCount() == 2);
+
+        bool thrown = false;
+        try
+        {
+            copy.Resize(5);
+        }
+        catch (const std::length_error &)
+        {
+            thrown = true;
+        }
+        assert(thrown && copy.Size() == 1);
+
+        // Исключение в конструкторе копирования не оставляет живых копий
+        v.Resize(3);
+        v[2].throw_on_copy = true;
+        thrown = false;
+        try
+        {
+            FixedVector<Obj, 4> broken = v;
+        }
+        catch (const std::runtime_error &)
+        {
+            thrown = true;
+        }
+        assert(thrown && Obj::GetAliveObjectCount() == 4);
+        v.Clear();
+        assert(Obj::GetAliveObjectCount() == 1);
+    }
+    assert(Obj::GetAliveObjectCount() == 0);
+}
+
+// Политика проверок для тестов: нарушение выбрасывает исключение вместо аварийного завершения
+struct ThrowingChecks
+{
+    static constexpr bool CHECK_BOUNDS = true;
+    static constexpr bool TRACK_ITERATORS = true;
+
+    static void OnViolation(const char *message)
+    {
+        throw std::logic_error(message);
+    }
+};
+
+template <typename Func>
+bool ViolatesChecks(Func func)
+{
+    try
+    {
+        func();
+    }
+    catch (const std::logic_error &)
+    {
+        return true;
+    }
+    return false;
+}
+
+void Test33()
+{
+    {
+        Vector<int> v(3);
+        assert(v.At(2) == 0);
+        bool thrown = false;
+        try
+        {
+            v.At(3);
+        }
+        catch (const std::out_of_range &)
+        {
+            thrown = true;
+        }
+        assert(thrown);
+    }
+    {
+        // Проверки без отслеживания итераторов не меняют размер вектора и тип итератора
+        using TrapVector = Vector<int, std::allocator<int>, DoublingGrowth, NoStats, TrapChecks>;
+        static_assert(sizeof(TrapVector) == sizeof(Vector<int>));
+        static_assert(std::is_same_v<TrapVector::iterator, int *>);
+        static_assert(noexcept(std::declval<TrapVector &>()[0]));
+        TrapVector v;
+        v.PushBack(1);
+        v.PushBack(2);
+        assert(v[1] == 2 && v.Data() == &v[0]);
+        v.PopBack();
+        assert(v.Size() == 1);
+    }
+    {
+        using CheckedVector = Vector<Obj, std::allocator<Obj>, DoublingGrowth, NoStats, ThrowingChecks>;
+        CheckedVector v;
+        v.Reserve(2);
+        v.EmplaceBack(1);
+        v.EmplaceBack(2);
+        auto it = v.begin();
+        assert(it->id == 1 && it[1].id == 2);
+
+        // Реаллокация при вставке делает прежние итераторы недействительными
+        v.EmplaceBack(3);
+        assert(ViolatesChecks([&]
+                              { return it->id; }));
+        it = v.begin();
+        assert(!ViolatesChecks([&]
+                               { return it[2].id; }));
+        v.Reserve(100);
+        assert(ViolatesChecks([&]
+                              { return it->id; }));
+        assert(ViolatesChecks([&]
+                              { v.Erase(it); }));
+        assert(v.Size() == 3);
+
+        // Расширение без реаллокации итераторы сохраняет, но конец вектора проверяется
+        CheckedVector::const_iterator first = v.cbegin();
+        auto last = v.end() - 1;
+        v.PopBack();
+        assert(first->id == 1);
+        assert(ViolatesChecks([&]
+                              { return last->id; }));
+        assert(ViolatesChecks([&]
+                              { return v[2].id; }));
+
+        // Итераторы чужого вектора
+        CheckedVector other = v;
+        assert(ViolatesChecks([&]
+                              { v.Erase(other.begin()); }));
+
+        // Обычные алгоритмы работают с проверяемыми итераторами
+        v.Insert(v.begin(), Obj(5));
+        v.Erase(v.begin() + 1, v.begin() + 2);
+        assert(std::distance(v.begin(), v.end()) == 2 && v[0].id == 5 && v[1].id == 2);
+        int sum = 0;
+        for (const Obj &obj : v)
+        {
+            sum += obj.id;
+        }
+        assert(sum == 7);
+
+        v.Clear();
+        assert(ViolatesChecks([&]
+                              { v.PopBack(); }));
+        assert(ViolatesChecks([&]
+                              { return *first; }));
+    }
+    {
+        Vector<int, std::allocator<int>, DoublingGrowth, NoStats, DebugChecks> v;
+        for (int i = 10; i > 0; --i)
+        {
+            v.PushBack(i);
+        }
+        std::sort(v.begin(), v.end());
+        assert(std::is_sorted(v.cbegin(), v.cend()) && v[0] == 1);
+        assert(simd::Sum(v) == 55 && *simd::Find(v, 4) == 4);
+    }
+    assert(Obj::GetAliveObjectCount() == 0);
+}
+
+template <typename Search>
+void CheckFlatMapAgainstStdMap()
+{
+    FlatMap<int, int, std::less<int>, Search> flat;
+    std::map<int, int> reference;
+    unsigned state = 1;
+    const auto next = [&state]
+    {
+        state = state * 1103515245 + 12345;
+        return static_cast<int>((state >> 16) % 500);
+    };
+    for (int round = 0; round < 20; ++round)
+    {
+        std::vector<std::pair<int, int>> batch;
+        for (int i = 0; i < 50; ++i)
+        {
+            batch.emplace_back(next(), round * 100 + i);
+        }
+        flat.BulkInsert(batch);
+        reference.insert(batch.begin(), batch.end());
+        for (int i = 0; i < 10; ++i)
+        {
+            const int key = next();
+            assert(flat.Erase(key) == reference.erase(key));
+            flat.InsertOrAssign(key + 1, i);
+            reference.insert_or_assign(key + 1, i);
+        }
+        const int from = next();
+        size_t erased = 0;
+        for (auto it = reference.lower_bound(from); it != reference.end() && it->first < from + 20;)
+        {
+            it = reference.erase(it);
+            ++erased;
+        }
+        assert(flat.EraseRange(from, from + 20) == erased);
+
+        assert(flat.Size() == reference.size());
+        auto expected = reference.begin();
+        for (auto [key, value] : std::as_const(flat))
+        {
+            assert(key == expected->first && value == expected->second);
+            ++expected;
+        }
+        for (int key = -1; key <= 501; ++key)
+        {
+            const int *value = flat.Find(key);
+            const auto it = reference.find(key);
+            assert((value == nullptr) == (it == reference.end()));
+            assert(value == nullptr || *value == it->second);
+        }
+    }
+}
+
+void Test34()
+{
+    {
+        FlatSet<int> set{5, 1, 3};
+        const int more[] = {4, 3, 2, 4, 0};
+        set.BulkInsert(more);
+        assert(set.Size() == 6 && std::is_sorted(set.begin(), set.end()));
+        assert(set.Contains(0) && set.Contains(5) && !set.Contains(6));
+        assert(*set.LowerBound(-1) == 0 && set.LowerBound(6) == set.end());
+        assert(!set.Insert(3).second && set.Insert(7).second && *set.Find(7) == 7);
+        assert(set.EraseRange(1, 4) == 3 && set.Size() == 4);
+        assert(set.Erase(5) == 1 && set.Erase(5) == 0);
+        assert(set.Keys().Size() == 3 && set.Keys()[0] == 0 && set.Keys()[2] == 7);
+    }
+    {
+        // Поиск по индексу Эйтцингера совпадает с lower_bound при любом размере дерева
+        for (int size = 0; size < 70; ++size)
+        {
+            FlatSet<int, std::less<int>, EytzingerSearch> set;
+            std::vector<int> keys;
+            for (int i = 0; i < size; ++i)
+            {
+                keys.push_back(i * 2);
+            }
+            set.BulkInsert(keys);
+            for (int key = -1; key <= size * 2; ++key)
+            {
+                const auto expected = std::lower_bound(keys.begin(), keys.end(), key) - keys.begin();
+                assert(set.LowerBound(key) - set.begin() == expected);
+            }
+        }
+    }
+    CheckFlatMapAgainstStdMap<BranchlessSearch>();
+    CheckFlatMapAgainstStdMap<EytzingerSearch>();
+    {
+        FlatMap<std::string, Obj, std::greater<std::string>> map;
+        map["b"].id = 2;
+        assert(map.TryEmplace("a", 1).second && !map.TryEmplace("a", 10).second);
+        assert(map.At("a").id == 1 && map.Keys()[0] == "b");
+        assert(Obj::GetAliveObjectCount() == 2);
+
+        // Если конструктор значения выбросит исключение, ключ не добавится
+        Obj thrower(3);
+        thrower.throw_on_copy = true;
+        bool thrown = false;
+        try
+        {
+            map.TryEmplace("c", thrower);
+        }
+        catch (const std::runtime_error &)
+        {
+            thrown = true;
+        }
+        assert(thrown && map.Size() == 2 && !map.Contains("c"));
+
+        thrown = false;
+        try
+        {
+            map.At("c");
+        }
+        catch (const std::out_of_range &)
+        {
+            thrown = true;
+        }
+        assert(thrown);
+
+        // Из пар с одинаковым ключом добавляется первая, имеющиеся значения не заменяются
+        std::vector<std::pair<std::string, Obj>> batch;
+        batch.emplace_back("d", Obj(4));
+        batch.emplace_back("a", Obj(100));
+        batch.emplace_back("d", Obj(200));
+        map.BulkInsert(batch);
+        assert(map.Size() == 3 && map.At("d").id == 4 && map.At("a").id == 1);
+        assert(map.Values()[0].id == 4 && map.Values()[2].id == 1);
+    }
+    assert(Obj::GetAliveObjectCount() == 0);
+    {
+        // Перемещение значения может выбросить исключение, поэтому BulkInsert копирует
+        // и ключи, и значения: исключение при копировании значения не портит ключи
+        struct CopyMayThrow
+        {
+            explicit CopyMayThrow(int value)
+                : value(value)
+            {
+            }
+            CopyMayThrow(const CopyMayThrow &other)
+                : value(other.value)
+                , throw_on_copy(other.throw_on_copy)
+            {
+                if (throw_on_copy)
+                {
+                    throw std::runtime_error("copy");
+                }
+            }
+            CopyMayThrow(CopyMayThrow &&other) noexcept(false)
+                : value(other.value)
+            {
+            }
+            CopyMayThrow &operator=(const CopyMayThrow &) = default;
+
+            int value;
+            bool throw_on_copy = false;
+        };
+
+        FlatMap<std::string, CopyMayThrow> map;
+        map.TryEmplace("first key, longer than the small string buffer", 1);
+        map.TryEmplace("second", 2);
+        map.TryEmplace("third", 3);
+        map.At("second").throw_on_copy = true;
+        bool thrown = false;
+        try
+        {
+            map.BulkInsert(std::vector<std::pair<std::string, CopyMayThrow>>{{"zero", CopyMayThrow(0)}});
+        }
+        catch (const std::runtime_error &)
+        {
+            thrown = true;
+        }
+        assert(thrown && map.Size() == 3 && !map.Contains("zero"));
+        assert(map.Keys()[0] == "first key, longer than the small string buffer" && map.Keys()[1] == "second");
+        assert(map.Keys()[2] == "third" && map.At("third").value == 3);
+    }
+}
+
+// Сводка места, находящегося в текущем файле на строке line
+const VectorSiteProfile &FindSiteProfile(const Vector<VectorSiteProfile> &profiles, unsigned line)
+{
+    const std::string_view file = VectorSourceLocation::Current().file;
+    for (const VectorSiteProfile &profile : profiles)
+    {
+        if (profile.location.line == line && profile.location.file == file)
+        {
+            return profile;
+        }
+    }
+    throw std::logic_error("no profile for site");
+}
+
+void Test35()
+{
+    const unsigned grow_line = VectorSourceLocation::Current().line + 4;
+    const unsigned reserve_line = VectorSourceLocation::Current().line + 4;
+    const unsigned small_line = VectorSourceLocation::Current().line + 12;
+    {
+        ProfiledVector<int> grown;
+        ProfiledVector<int> reserved;
+        reserved.Reserve(100);
+        for (int i = 0; i < 100; ++i)
+        {
+            grown.PushBack(i);
+            reserved.PushBack(i);
+        }
+        for (int i = 0; i < 10; ++i)
+        {
+            ProfiledVector<int> small;
+            small.PushBack(i);
+            small.PushBack(i);
+        }
+        grown.Resize(65);
+
+        const Vector<VectorSiteProfile> profiles = VectorProfiler::Snapshot();
+        const VectorSiteProfile &grow_site = FindSiteProfile(profiles, grow_line);
+        // Рост 1, 2, 4, ..., 128: семь реаллокаций с переносом 1 + 2 + ... + 64 элементов
+        assert(grow_site.live_instances == 1 && grow_site.reallocations == 7);
+        assert(grow_site.relocated_bytes == 127 * sizeof(int));
+        assert(grow_site.live_size_bytes == 65 * sizeof(int) && grow_site.SlackBytes() == 63 * sizeof(int));
+
+        // Выделение в Reserve приписывается месту вызова Reserve, вектор реаллокаций не делал
+        const VectorSiteProfile &reserve_site = FindSiteProfile(profiles, reserve_line);
+        assert(reserve_site.reallocations == 0 && reserve_site.allocations == 0);
+        assert(reserve_site.live_capacity_bytes == 100 * sizeof(int) && reserve_site.SlackBytes() == 0);
+        const VectorSiteProfile &reserve_call = FindSiteProfile(profiles, reserve_line + 1);
+        assert(reserve_call.allocations == 1 && reserve_call.allocated_bytes == 100 * sizeof(int));
+
+        const VectorSiteProfile &small_site = FindSiteProfile(profiles, small_line);
+        assert(small_site.constructed == 10 && small_site.live_instances == 0);
+        assert(small_site.AverageFinalSize() == 2.0 && small_site.reallocations == 10);
+
+        // Места упорядочены по перенесенным и простаивающим байтам
+        for (size_t i = 1; i < profiles.Size(); ++i)
+        {
+            assert(profiles[i - 1].relocated_bytes + profiles[i - 1].SlackBytes() >=
+                   profiles[i].relocated_bytes + profiles[i].SlackBytes());
+        }
+
+        std::ostringstream report;
+        VectorProfiler::Report(report, 3);
+        assert(report.str().find("main.cpp:" + std::to_string(grow_line)) != std::string::npos);
+
+        // Копия учитывается по месту, где она создана, а перемещенный вектор — по месту исходного
+        const unsigned copy_line = VectorSourceLocation::Current().line + 1;
+        ProfiledVector<int> copy = grown;
+        static_assert(std::is_nothrow_move_constructible_v<ProfiledVector<int>>);
+        ProfiledVector<int> moved(std::move(copy));
+        const Vector<VectorSiteProfile> after_copy = VectorProfiler::Snapshot();
+        const VectorSiteProfile &copy_site = FindSiteProfile(after_copy, copy_line);
+        assert(copy_site.allocations == 1 && copy_site.live_instances == 2);
+        assert(copy_site.live_size_bytes == 65 * sizeof(int));
+
+        // Параллельный Reserve тоже приписывается месту своего вызова
+        moved.Reserve(1000, PARALLEL);
+        const Vector<VectorSiteProfile> after_reserve = VectorProfiler::Snapshot();
+        assert(FindSiteProfile(after_reserve, copy_line + 9).allocations == 1);
+        assert(moved.Capacity() == 1000 && moved[64] == 64);
     }
+    const Vector<VectorSiteProfile> after_destroy = VectorProfiler::Snapshot();
+    const VectorSiteProfile &grow_site = FindSiteProfile(after_destroy, grow_line);
+    assert(grow_site.live_instances == 0 && grow_site.final_size_sum == 65);
 }
 
 int main()
@@ -695,7 +3222,35 @@ int main()
         Test4();
         Test5();
         Test6();
-        Benchmark();
+        Test7();
+        Test8();
+        Test9();
+        Test10();
+        Test11();
+        Test12();
+        Test13();
+        Test14();
+        Test15();
+        Test16();
+        Test17();
+        Test18();
+        Test19();
+        Test20();
+        Test21();
+        Test22();
+        Test23();
+        Test24();
+        Test25();
+        Test26();
+        Test27();
+        Test28();
+        Test29();
+        Test30();
+        Test31();
+        Test32();
+        Test33();
+        Test34();
+        Test35();
     }
     catch (const std::exception &e)
     {
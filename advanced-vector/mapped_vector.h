@@ -0,0 +1,318 @@
+#pragma once
+#include "vector.h"
+
+#include <cerrno>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#ifndef __linux__
+#error "mapped_vector.h requires Linux (mremap)"
+#endif
+
+// Файл, отображаемый в память MappedFileAllocator. Формат файла:
+//     [Header, HEADER_SIZE байт][элементы вектора][неиспользуемая емкость]
+// Заголовок хранит размер вектора на момент последнего SyncMappedVector. Файл может быть
+// отображен только одним буфером: второе отображение указывало бы на те же элементы
+class MappedFile
+{
+public:
+    static constexpr size_t HEADER_SIZE = 64;
+    static constexpr uint64_t MAGIC = 0x31564d4150414d56; // "VMAPAMV1"
+
+    struct Header
+    {
+        uint64_t magic = MAGIC;
+        uint64_t element_size = 0;
+        uint64_t size = 0;
+    };
+
+    explicit MappedFile(const std::string &path)
+        : fd_(::open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644))
+    {
+        if (fd_ < 0)
+        {
+            throw std::system_error(errno, std::generic_category(), "open " + path);
+        }
+    }
+
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    ~MappedFile()
+    {
+        ::close(fd_);
+    }
+
+    int Descriptor() const noexcept
+    {
+        return fd_;
+    }
+
+    size_t Length() const
+    {
+        struct stat st;
+        if (::fstat(fd_, &st) != 0)
+        {
+            throw std::system_error(errno, std::generic_category(), "fstat");
+        }
+        return static_cast<size_t>(st.st_size);
+    }
+
+    void SetLength(size_t length)
+    {
+        if (::ftruncate(fd_, static_cast<off_t>(length)) != 0)
+        {
+            throw std::system_error(errno, std::generic_category(), "ftruncate");
+        }
+    }
+
+    // Отображен ли файл буфером одного из аллокаторов
+    bool Mapped() const noexcept
+    {
+        return mapped_;
+    }
+
+    void SetMapped(bool mapped) noexcept
+    {
+        mapped_ = mapped;
+    }
+
+    Header ReadHeader() const
+    {
+        Header header;
+        if (::pread(fd_, &header, sizeof(header), 0) != static_cast<ssize_t>(sizeof(header)))
+        {
+            throw std::system_error(errno, std::generic_category(), "pread");
+        }
+        return header;
+    }
+
+    void WriteHeader(const Header &header)
+    {
+        if (::pwrite(fd_, &header, sizeof(header), 0) != static_cast<ssize_t>(sizeof(header)))
+        {
+            throw std::system_error(errno, std::generic_category(), "pwrite");
+        }
+    }
+
+private:
+    int fd_;
+    bool mapped_ = false;
+};
+
+// Аллокатор, выделяющий буфер через mmap. Рост и сжатие выполняются через mremap без
+// копирования элементов, поэтому Vector с таким аллокатором переносит буфер целиком
+// (см. RawMemory::Reallocate) и подходит только для тривиально перемещаемых T.
+// Аллокатор, связанный с файлом, отображает его с MAP_SHARED: элементы вектора хранятся
+// прямо в файле, а его длина увеличивается через ftruncate. Аллокатор по умолчанию
+// использует анонимную память; его получают копии файлового вектора, чтобы копия
+// не писала в тот же файл. Пока буфер файла не освобожден, выделить второй нельзя:
+// allocate выбрасывает std::logic_error, а рост выполняется через reallocate
+template <typename T>
+class MappedFileAllocator
+{
+    static_assert(std::is_trivially_copyable_v<T>, "MappedFileAllocator requires trivially copyable T");
+    static_assert(alignof(T) <= MappedFile::HEADER_SIZE, "T is over-aligned for MappedFile");
+
+public:
+    using value_type = T;
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap = std::true_type;
+
+    template <typename U>
+    friend class MappedFileAllocator;
+
+    MappedFileAllocator() = default;
+
+    explicit MappedFileAllocator(std::shared_ptr<MappedFile> file) noexcept
+        : file_(std::move(file))
+    {
+    }
+
+    template <typename U>
+    MappedFileAllocator(const MappedFileAllocator<U> &other) noexcept
+        : file_(other.file_)
+    {
+    }
+
+    MappedFileAllocator select_on_container_copy_construction() const noexcept
+    {
+        return MappedFileAllocator();
+    }
+
+    const std::shared_ptr<MappedFile> &File() const noexcept
+    {
+        return file_;
+    }
+
+    T *allocate(size_t n)
+    {
+        const size_t length = MappedLength(n);
+        void *base = nullptr;
+        if (file_)
+        {
+            if (file_->Mapped())
+            {
+                throw std::logic_error("MappedFileAllocator: file is already mapped");
+            }
+            // Файл только удлиняется: данные за пределами n элементов сохраняются
+            if (file_->Length() < length)
+            {
+                file_->SetLength(length);
+            }
+            base = ::mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_SHARED, file_->Descriptor(), 0);
+        }
+        else
+        {
+            base = ::mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        }
+        if (base == MAP_FAILED)
+        {
+            throw std::bad_alloc();
+        }
+        if (file_)
+        {
+            file_->SetMapped(true);
+        }
+        return FromBase(base);
+    }
+
+    void deallocate(T *p, size_t n) noexcept
+    {
+        ::munmap(ToBase(p), MappedLength(n));
+        if (file_)
+        {
+            file_->SetMapped(false);
+        }
+    }
+
+    // При неудаче выбрасывает исключение, исходное отображение остается действительным
+    T *reallocate(T *p, size_t old_n, size_t new_n)
+    {
+        if (p == nullptr)
+        {
+            return allocate(new_n);
+        }
+        const size_t new_length = MappedLength(new_n);
+        if (file_ && new_n > old_n && file_->Length() < new_length)
+        {
+            file_->SetLength(new_length);
+        }
+        void *base = ::mremap(ToBase(p), MappedLength(old_n), new_length, MREMAP_MAYMOVE);
+        if (base == MAP_FAILED)
+        {
+            throw std::bad_alloc();
+        }
+        if (file_ && new_n < old_n)
+        {
+            file_->SetLength(new_length);
+        }
+        return FromBase(base);
+    }
+
+    template <typename U>
+    bool operator==(const MappedFileAllocator<U> &other) const noexcept
+    {
+        return file_ == other.file_;
+    }
+
+    template <typename U>
+    bool operator!=(const MappedFileAllocator<U> &other) const noexcept
+    {
+        return !(*this == other);
+    }
+
+private:
+    static size_t MappedLength(size_t n) noexcept
+    {
+        return MappedFile::HEADER_SIZE + n * sizeof(T);
+    }
+
+    static T *FromBase(void *base) noexcept
+    {
+        return reinterpret_cast<T *>(static_cast<char *>(base) + MappedFile::HEADER_SIZE);
+    }
+
+    static void *ToBase(T *p) noexcept
+    {
+        return reinterpret_cast<char *>(p) - MappedFile::HEADER_SIZE;
+    }
+
+    std::shared_ptr<MappedFile> file_;
+};
+
+template <typename T, typename Growth = DoublingGrowth>
+using MappedVector = Vector<T, MappedFileAllocator<T>, Growth>;
+
+// Открывает (или создает) файл path и отображает его содержимое в вектор без копирования:
+// страницы читаются с диска при первом обращении. Емкость вектора равна емкости файла.
+// Заголовок записывается только в пустой файл; файл с неполным или чужим заголовком
+// не изменяется, а выбрасывается std::runtime_error.
+// Элементы, добавленные после последнего SyncMappedVector, при повторном открытии не видны
+template <typename T, typename Growth = DoublingGrowth>
+MappedVector<T, Growth> OpenMappedVector(const std::string &path)
+{
+    auto file = std::make_shared<MappedFile>(path);
+    MappedFileAllocator<T> alloc(file);
+    const size_t length = file->Length();
+    if (length == 0)
+    {
+        MappedFile::Header header;
+        header.element_size = sizeof(T);
+        file->SetLength(MappedFile::HEADER_SIZE);
+        file->WriteHeader(header);
+        return MappedVector<T, Growth>(alloc);
+    }
+    if (length < MappedFile::HEADER_SIZE)
+    {
+        // Непустой файл без полного заголовка — чужой или поврежденный, и перезаписывать его нельзя
+        throw std::runtime_error("MappedVector: " + path + " is too short for the header");
+    }
+
+    const MappedFile::Header header = file->ReadHeader();
+    const size_t capacity = (length - MappedFile::HEADER_SIZE) / sizeof(T);
+    if (header.magic != MappedFile::MAGIC || header.element_size != sizeof(T) || header.size > capacity)
+    {
+        throw std::runtime_error("MappedVector: " + path + " has incompatible format");
+    }
+    if (capacity == 0)
+    {
+        return MappedVector<T, Growth>(alloc);
+    }
+    return MappedVector<T, Growth>::Adopt(alloc.allocate(capacity), header.size, capacity, alloc);
+}
+
+// Записывает размер вектора в заголовок файла и сбрасывает изменения на диск (msync)
+template <typename T, typename Growth>
+void SyncMappedVector(const MappedVector<T, Growth> &v)
+{
+    const std::shared_ptr<MappedFile> &file = v.GetAllocator().File();
+    if (!file)
+    {
+        return;
+    }
+    MappedFile::Header header;
+    header.element_size = sizeof(T);
+    header.size = v.Size();
+    file->WriteHeader(header);
+    if (v.Capacity() == 0)
+    {
+        if (::fdatasync(file->Descriptor()) != 0)
+        {
+            throw std::system_error(errno, std::generic_category(), "fdatasync");
+        }
+        return;
+    }
+    void *base = const_cast<char *>(reinterpret_cast<const char *>(v.Data())) - MappedFile::HEADER_SIZE;
+    if (::msync(base, MappedFile::HEADER_SIZE + v.Capacity() * sizeof(T), MS_SYNC) != 0)
+    {
+        throw std::system_error(errno, std::generic_category(), "msync");
+    }
+}
\ No newline at end of file
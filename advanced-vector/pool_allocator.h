@@ -0,0 +1,203 @@
+#pragma once
+#include "vector.h"
+
+#include <cstddef>
+#include <limits>
+#include <new>
+
+namespace pool_detail
+{
+    // Классы размеров — степени двойки от MIN_BLOCK до MAX_BLOCK байт. Более крупные буферы
+    // выделяются и освобождаются напрямую через operator new/delete
+    inline constexpr size_t MIN_BLOCK = 16;
+    static_assert(MIN_BLOCK == 16, "SizeClass assumes MIN_BLOCK == 2^4");
+    inline constexpr size_t MAX_BLOCK = 64 * 1024;
+    // Сколько памяти поток держит в списке свободных блоков одного класса
+    inline constexpr size_t MAX_CACHED_BYTES = 1024 * 1024;
+
+    inline constexpr size_t CLASS_COUNT = []
+    {
+        size_t count = 1;
+        for (size_t block = MIN_BLOCK; block < MAX_BLOCK; block *= 2)
+        {
+            ++count;
+        }
+        return count;
+    }();
+
+    // Номер класса размеров для буфера из bytes байт, bytes <= MAX_BLOCK
+    inline size_t SizeClass(size_t bytes) noexcept
+    {
+        if (bytes <= MIN_BLOCK)
+        {
+            return 0;
+        }
+#if defined(__GNUC__)
+        // Степень двойки, не меньшая bytes, — 2^(64 - clz(bytes - 1)); MIN_BLOCK = 2^4
+        return std::numeric_limits<unsigned long long>::digits - __builtin_clzll(bytes - 1) - 4;
+#else
+        size_t size_class = 0;
+        for (size_t block = MIN_BLOCK; block < bytes; block *= 2)
+        {
+            ++size_class;
+        }
+        return size_class;
+#endif
+    }
+
+    inline constexpr size_t ClassSize(size_t size_class) noexcept
+    {
+        return MIN_BLOCK << size_class;
+    }
+
+    struct FreeBlock
+    {
+        FreeBlock *next;
+    };
+
+    // Списки свободных блоков потока. Блоки не привязаны к потоку, который их выделил:
+    // буфер, освобожденный в другом потоке, попадает в списки этого потока.
+    // Структура тривиальна, поэтому обращение к ней не требует проверки инициализации
+    // thread_local; блоки освобождает ThreadCacheReleaser при завершении потока
+    struct ThreadCache
+    {
+        FreeBlock *free[CLASS_COUNT];
+        size_t counts[CLASS_COUNT];
+        bool registered;
+        bool destroyed;
+    };
+
+    inline thread_local ThreadCache thread_cache = {};
+
+    struct ThreadCacheReleaser
+    {
+        ~ThreadCacheReleaser()
+        {
+            for (size_t size_class = 0; size_class < CLASS_COUNT; ++size_class)
+            {
+                while (FreeBlock *block = thread_cache.free[size_class])
+                {
+                    thread_cache.free[size_class] = block->next;
+                    operator delete(block, ClassSize(size_class));
+                }
+                thread_cache.counts[size_class] = 0;
+            }
+            // Блоки, освобожденные после этого момента, сразу возвращаются в operator delete
+            thread_cache.destroyed = true;
+        }
+    };
+
+    inline void *Pop(size_t size_class) noexcept
+    {
+        ThreadCache &cache = thread_cache;
+        FreeBlock *block = cache.free[size_class];
+        if (block != nullptr)
+        {
+            cache.free[size_class] = block->next;
+            --cache.counts[size_class];
+        }
+        return block;
+    }
+
+    // Возвращает false, если блок нужно освободить: список класса заполнен или поток завершается
+    inline bool Push(void *p, size_t size_class) noexcept
+    {
+        ThreadCache &cache = thread_cache;
+        if (cache.destroyed || cache.counts[size_class] * ClassSize(size_class) >= MAX_CACHED_BYTES)
+        {
+            return false;
+        }
+        if (!cache.registered)
+        {
+            // Первый сохраненный блок: регистрируем освобождение списков при завершении потока
+            cache.registered = true;
+            thread_local ThreadCacheReleaser releaser;
+            (void)releaser;
+        }
+        cache.free[size_class] = new (p) FreeBlock{cache.free[size_class]};
+        ++cache.counts[size_class];
+        return true;
+    }
+} // namespace pool_detail
+
+// Аллокатор, повторно использующий буферы через списки свободных блоков потока.
+// Буфер до MAX_BLOCK байт округляется до степени двойки, а при освобождении попадает
+// в список своего класса размеров в текущем потоке, откуда его без блокировок и без
+// обращения к operator new заберет следующий вектор. Подходит для множества короткоживущих
+// небольших векторов. Каждый поток хранит не больше MAX_CACHED_BYTES на класс, остальное
+// возвращается в operator delete; при завершении потока его блоки освобождаются.
+// Вектор может расти в пределах класса без переноса (try_expand). Чтобы емкость вектора
+// совпадала с классами размеров, используйте политику роста PoolGrowth
+template <typename T>
+struct PoolAllocator
+{
+    static_assert(alignof(T) <= __STDCPP_DEFAULT_NEW_ALIGNMENT__, "PoolAllocator does not support over-aligned types");
+
+    static constexpr size_t MAX_BLOCK = pool_detail::MAX_BLOCK;
+
+    using value_type = T;
+    using is_always_equal = std::true_type;
+
+    PoolAllocator() = default;
+
+    template <typename U>
+    PoolAllocator(const PoolAllocator<U> & /*other*/) noexcept
+    {
+    }
+
+    T *allocate(size_t n)
+    {
+        const size_t bytes = n * sizeof(T);
+        if (bytes > MAX_BLOCK)
+        {
+            return static_cast<T *>(operator new(bytes));
+        }
+        const size_t size_class = pool_detail::SizeClass(bytes);
+        if (void *p = pool_detail::Pop(size_class))
+        {
+            return static_cast<T *>(p);
+        }
+        return static_cast<T *>(operator new(pool_detail::ClassSize(size_class)));
+    }
+
+    void deallocate(T *p, size_t n) noexcept
+    {
+        const size_t bytes = n * sizeof(T);
+        if (bytes > MAX_BLOCK)
+        {
+            operator delete(p, bytes);
+            return;
+        }
+        const size_t size_class = pool_detail::SizeClass(bytes);
+        if (!pool_detail::Push(p, size_class))
+        {
+            operator delete(p, pool_detail::ClassSize(size_class));
+        }
+    }
+
+    // Блок можно расширить, пока новый размер остается в том же классе
+    bool try_expand(T * /*p*/, size_t old_n, size_t new_n) noexcept
+    {
+        const size_t old_bytes = old_n * sizeof(T);
+        const size_t new_bytes = new_n * sizeof(T);
+        return new_bytes <= MAX_BLOCK && pool_detail::SizeClass(new_bytes) == pool_detail::SizeClass(old_bytes);
+    }
+
+    template <typename U>
+    bool operator==(const PoolAllocator<U> & /*other*/) const noexcept
+    {
+        return true;
+    }
+
+    template <typename U>
+    bool operator!=(const PoolAllocator<U> & /*other*/) const noexcept
+    {
+        return false;
+    }
+};
+
+// Рост с округлением емкости до классов размеров PoolAllocator
+using PoolGrowth = SizeClassGrowth<DoublingGrowth, pool_detail::MAX_BLOCK, pool_detail::MIN_BLOCK>;
+
+template <typename T>
+using PoolVector = Vector<T, PoolAllocator<T>, PoolGrowth>;
\ No newline at end of file
@@ -0,0 +1,455 @@
+#pragma once
+#include "vector.h"
+
+namespace segmented_detail
+{
+    // Размер блока по умолчанию — степень двойки элементов, занимающая не больше страницы
+    template <typename T>
+    constexpr size_t DefaultBlockSize() noexcept
+    {
+        constexpr size_t PAGE_SIZE = 4096;
+        size_t block_size = 1;
+        while (block_size * 2 * sizeof(T) <= PAGE_SIZE)
+        {
+            block_size *= 2;
+        }
+        return block_size;
+    }
+} // namespace segmented_detail
+
+// Вектор, растущий добавлением блоков RawMemory по BLOCK_SIZE элементов. Уже созданные
+// элементы никогда не переносятся: ссылки и указатели на них остаются действительными до
+// удаления самих элементов, а рост не требует временного удвоения памяти.
+// Индексация за O(1) через таблицу блоков. Segments() перебирает блоки как непрерывные
+// диапазоны Span<T>, что удобно для обхода без вычисления адреса каждого элемента.
+// Вставка и удаление поддерживаются только в конце: сдвиг элементов противоречил бы
+// стабильности адресов
+template <typename T, typename Alloc = std::allocator<T>,
+          size_t BLOCK_SIZE = segmented_detail::DefaultBlockSize<T>()>
+class SegmentedVector
+{
+    static_assert(BLOCK_SIZE > 0 && (BLOCK_SIZE & (BLOCK_SIZE - 1)) == 0, "BLOCK_SIZE must be a power of two");
+
+    using Block = RawMemory<T, Alloc>;
+
+public:
+    using allocator_type = Alloc;
+
+    static constexpr size_t BLOCK_CAPACITY = BLOCK_SIZE;
+
+    template <bool IS_CONST>
+    class Iterator
+    {
+        using Owner = std::conditional_t<IS_CONST, const SegmentedVector, SegmentedVector>;
+
+    public:
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = std::conditional_t<IS_CONST, const T *, T *>;
+        using reference = std::conditional_t<IS_CONST, const T &, T &>;
+
+        Iterator() = default;
+
+        Iterator(Owner *owner, size_t index) noexcept
+            : owner_(owner), index_(index)
+        {
+        }
+
+        // Неконстантный итератор преобразуется в константный
+        template <bool OTHER_CONST, typename = std::enable_if_t<IS_CONST && !OTHER_CONST>>
+        Iterator(const Iterator<OTHER_CONST> &other) noexcept
+            : owner_(other.owner_), index_(other.index_)
+        {
+        }
+
+        reference operator*() const noexcept
+        {
+            return (*owner_)[index_];
+        }
+        pointer operator->() const noexcept
+        {
+            return &(*owner_)[index_];
+        }
+        reference operator[](difference_type n) const noexcept
+        {
+            return (*owner_)[index_ + n];
+        }
+
+        Iterator &operator++() noexcept
+        {
+            ++index_;
+            return *this;
+        }
+        Iterator operator++(int) noexcept
+        {
+            Iterator old = *this;
+            ++index_;
+            return old;
+        }
+        Iterator &operator--() noexcept
+        {
+            --index_;
+            return *this;
+        }
+        Iterator operator--(int) noexcept
+        {
+            Iterator old = *this;
+            --index_;
+            return old;
+        }
+        Iterator &operator+=(difference_type n) noexcept
+        {
+            index_ += n;
+            return *this;
+        }
+        Iterator &operator-=(difference_type n) noexcept
+        {
+            index_ -= n;
+            return *this;
+        }
+        friend Iterator operator+(Iterator it, difference_type n) noexcept
+        {
+            return it += n;
+        }
+        friend Iterator operator+(difference_type n, Iterator it) noexcept
+        {
+            return it += n;
+        }
+        friend Iterator operator-(Iterator it, difference_type n) noexcept
+        {
+            return it -= n;
+        }
+        friend difference_type operator-(const Iterator &lhs, const Iterator &rhs) noexcept
+        {
+            return static_cast<difference_type>(lhs.index_) - static_cast<difference_type>(rhs.index_);
+        }
+
+        friend bool operator==(const Iterator &lhs, const Iterator &rhs) noexcept
+        {
+            return lhs.index_ == rhs.index_;
+        }
+        friend bool operator!=(const Iterator &lhs, const Iterator &rhs) noexcept
+        {
+            return lhs.index_ != rhs.index_;
+        }
+        friend bool operator<(const Iterator &lhs, const Iterator &rhs) noexcept
+        {
+            return lhs.index_ < rhs.index_;
+        }
+        friend bool operator>(const Iterator &lhs, const Iterator &rhs) noexcept
+        {
+            return rhs < lhs;
+        }
+        friend bool operator<=(const Iterator &lhs, const Iterator &rhs) noexcept
+        {
+            return !(rhs < lhs);
+        }
+        friend bool operator>=(const Iterator &lhs, const Iterator &rhs) noexcept
+        {
+            return !(lhs < rhs);
+        }
+
+    private:
+        template <bool>
+        friend class Iterator;
+
+        Owner *owner_ = nullptr;
+        size_t index_ = 0;
+    };
+
+    using iterator = Iterator<false>;
+    using const_iterator = Iterator<true>;
+
+    // Итератор по блокам: разыменование дает непрерывный диапазон элементов блока
+    template <bool IS_CONST>
+    class SegmentIterator
+    {
+        using Owner = std::conditional_t<IS_CONST, const SegmentedVector, SegmentedVector>;
+        using Element = std::conditional_t<IS_CONST, const T, T>;
+
+    public:
+        using iterator_category = std::input_iterator_tag;
+        using value_type = Span<Element>;
+        using difference_type = std::ptrdiff_t;
+        using pointer = void;
+        using reference = Span<Element>;
+
+        SegmentIterator(Owner *owner, size_t block) noexcept
+            : owner_(owner), block_(block)
+        {
+        }
+
+        Span<Element> operator*() const noexcept
+        {
+            return owner_->Segment(block_);
+        }
+
+        SegmentIterator &operator++() noexcept
+        {
+            ++block_;
+            return *this;
+        }
+        SegmentIterator operator++(int) noexcept
+        {
+            SegmentIterator old = *this;
+            ++block_;
+            return old;
+        }
+
+        bool operator==(const SegmentIterator &other) const noexcept
+        {
+            return block_ == other.block_;
+        }
+        bool operator!=(const SegmentIterator &other) const noexcept
+        {
+            return block_ != other.block_;
+        }
+
+    private:
+        Owner *owner_;
+        size_t block_;
+    };
+
+    template <bool IS_CONST>
+    class SegmentRange
+    {
+    public:
+        SegmentRange(SegmentIterator<IS_CONST> first, SegmentIterator<IS_CONST> last) noexcept
+            : first_(first), last_(last)
+        {
+        }
+
+        SegmentIterator<IS_CONST> begin() const noexcept
+        {
+            return first_;
+        }
+        SegmentIterator<IS_CONST> end() const noexcept
+        {
+            return last_;
+        }
+
+    private:
+        SegmentIterator<IS_CONST> first_;
+        SegmentIterator<IS_CONST> last_;
+    };
+
+    SegmentedVector() = default;
+
+    explicit SegmentedVector(const Alloc &alloc) noexcept
+        : alloc_(alloc)
+    {
+    }
+
+    SegmentedVector(const SegmentedVector &other)
+        : SegmentedVector(std::allocator_traits<Alloc>::select_on_container_copy_construction(other.alloc_)) //
+    {
+        Reserve(other.size_);
+        for (const T &value : other)
+        {
+            EmplaceBack(value);
+        }
+    }
+
+    SegmentedVector(SegmentedVector &&other) noexcept
+        : alloc_(other.alloc_)
+    {
+        Swap(other);
+    }
+
+    ~SegmentedVector()
+    {
+        Clear();
+    }
+
+    SegmentedVector &operator=(const SegmentedVector &rhs)
+    {
+        if (this != &rhs)
+        {
+            SegmentedVector(rhs).Swap(*this);
+        }
+        return *this;
+    }
+
+    SegmentedVector &operator=(SegmentedVector &&rhs) noexcept
+    {
+        if (this != &rhs)
+        {
+            Clear();
+            Swap(rhs);
+        }
+        return *this;
+    }
+
+    // Блоки переходят вместе со своими аллокаторами, поэтому аллокатор контейнера тоже обменивается
+    void Swap(SegmentedVector &other) noexcept
+    {
+        using std::swap;
+        swap(alloc_, other.alloc_);
+        blocks_.Swap(other.blocks_);
+        std::swap(size_, other.size_);
+    }
+
+    const Alloc &GetAllocator() const noexcept
+    {
+        return alloc_;
+    }
+
+    size_t Size() const noexcept
+    {
+        return size_;
+    }
+
+    size_t Capacity() const noexcept
+    {
+        return blocks_.Size() * BLOCK_SIZE;
+    }
+
+    // Выделяет блоки, пока емкость меньше new_capacity. Элементы не переносятся
+    void Reserve(size_t new_capacity)
+    {
+        if (new_capacity <= Capacity())
+        {
+            return;
+        }
+        const size_t blocks = (new_capacity + BLOCK_SIZE - 1) / BLOCK_SIZE;
+        blocks_.Reserve(blocks);
+        while (blocks_.Size() < blocks)
+        {
+            blocks_.EmplaceBack(BLOCK_SIZE, alloc_);
+        }
+    }
+
+    // Освобождает блоки, в которых нет элементов
+    void ShrinkToFit() noexcept
+    {
+        const size_t used_blocks = (size_ + BLOCK_SIZE - 1) / BLOCK_SIZE;
+        blocks_.Erase(blocks_.begin() + used_blocks, blocks_.end());
+    }
+
+    // Удаляет все элементы, сохраняя выделенные блоки
+    void Clear() noexcept
+    {
+        for (Span<T> segment : Segments())
+        {
+            std::destroy(segment.begin(), segment.end());
+        }
+        size_ = 0;
+    }
+
+    void Resize(size_t new_size)
+    {
+        while (size_ > new_size)
+        {
+            PopBack();
+        }
+        Reserve(new_size);
+        while (size_ < new_size)
+        {
+            EmplaceBack();
+        }
+    }
+
+    void PushBack(const T &value)
+    {
+        EmplaceBack(value);
+    }
+    void PushBack(T &&value)
+    {
+        EmplaceBack(std::move(value));
+    }
+
+    // Добавляет элемент в конец. Если нужен новый блок, он выделяется до создания элемента;
+    // при исключении размер вектора не меняется (строгая гарантия)
+    template <typename... Args>
+    T &EmplaceBack(Args &&...args)
+    {
+        if (size_ == Capacity())
+        {
+            // Аргументы могут ссылаться на элементы вектора: блоки не переезжают, ссылки
+            // остаются действительными при росте таблицы
+            blocks_.EmplaceBack(BLOCK_SIZE, alloc_);
+        }
+        T *slot = blocks_[size_ / BLOCK_SIZE] + size_ % BLOCK_SIZE;
+        new (slot) T(std::forward<Args>(args)...);
+        ++size_;
+        return *slot;
+    }
+
+    void PopBack() noexcept
+    {
+        assert(size_ > 0);
+        std::destroy_at(&(*this)[size_ - 1]);
+        --size_;
+    }
+
+    const T &operator[](size_t index) const noexcept
+    {
+        return const_cast<SegmentedVector &>(*this)[index];
+    }
+
+    T &operator[](size_t index) noexcept
+    {
+        assert(index < size_);
+        return blocks_[index / BLOCK_SIZE][index % BLOCK_SIZE];
+    }
+
+    iterator begin() noexcept
+    {
+        return {this, 0};
+    }
+    const_iterator begin() const noexcept
+    {
+        return {this, 0};
+    }
+    const_iterator cbegin() const noexcept
+    {
+        return begin();
+    }
+    iterator end() noexcept
+    {
+        return {this, size_};
+    }
+    const_iterator end() const noexcept
+    {
+        return {this, size_};
+    }
+    const_iterator cend() const noexcept
+    {
+        return end();
+    }
+
+    // Количество блоков, содержащих элементы
+    size_t SegmentCount() const noexcept
+    {
+        return (size_ + BLOCK_SIZE - 1) / BLOCK_SIZE;
+    }
+
+    // Элементы блока index, все блоки кроме последнего заполнены полностью
+    Span<T> Segment(size_t index) noexcept
+    {
+        assert(index < SegmentCount());
+        return {blocks_[index].GetAddress(), std::min(BLOCK_SIZE, size_ - index * BLOCK_SIZE)};
+    }
+
+    Span<const T> Segment(size_t index) const noexcept
+    {
+        assert(index < SegmentCount());
+        return {blocks_[index].GetAddress(), std::min(BLOCK_SIZE, size_ - index * BLOCK_SIZE)};
+    }
+
+    SegmentRange<false> Segments() noexcept
+    {
+        return {{this, 0}, {this, SegmentCount()}};
+    }
+
+    SegmentRange<true> Segments() const noexcept
+    {
+        return {{this, 0}, {this, SegmentCount()}};
+    }
+
+private:
+    Alloc alloc_;
+    Vector<Block> blocks_;
+    size_t size_ = 0;
+};
\ No newline at end of file
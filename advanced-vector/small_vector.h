@@ -0,0 +1,360 @@
+#pragma once
+#include "vector.h"
+
+// Вектор, хранящий первые N элементов во встроенном буфере.
+// Пока размер не превышает N, память в куче не выделяется. При росте за пределы N элементы
+// переносятся в RawMemory и дальше вектор ведет себя как Vector. Аллокатор распространяется
+// при перемещающем присваивании и обмене по правилам propagate_on_container_*, как в Vector.
+// Буфер в куче передается при перемещении и обмене без перемещения элементов, а встроенные
+// элементы перемещаются по одному: если конструктор перемещения T выбросит исключение,
+// операция дает только базовую гарантию
+template <typename T, size_t N, typename Alloc = std::allocator<T>, typename Growth = DoublingGrowth>
+class SmallVector
+{
+    static_assert(N > 0, "SmallVector requires non-zero inline capacity");
+
+    using AllocTraits = std::allocator_traits<Alloc>;
+    static constexpr bool PROPAGATE_ON_MOVE =
+        AllocTraits::propagate_on_container_move_assignment::value || AllocTraits::is_always_equal::value;
+
+public:
+    using allocator_type = Alloc;
+
+    static constexpr size_t INLINE_CAPACITY = N;
+
+    SmallVector() = default;
+
+    explicit SmallVector(const Alloc &alloc) noexcept
+        : heap_(alloc)
+    {
+    }
+
+    explicit SmallVector(size_t size, const Alloc &alloc = Alloc())
+        : heap_(alloc) //
+    {
+        Reserve(size);
+        std::uninitialized_value_construct_n(Data(), size);
+        size_ = size;
+    }
+    SmallVector(const SmallVector &other)
+        : heap_(AllocTraits::select_on_container_copy_construction(other.GetAllocator())) //
+    {
+        Reserve(other.size_);
+        std::uninitialized_copy_n(other.Data(), other.size_, Data());
+        size_ = other.size_;
+    }
+    SmallVector(SmallVector &&other) noexcept(std::is_nothrow_move_constructible_v<T>)
+        : heap_(other.GetAllocator())
+    {
+        if (other.IsInline())
+        {
+            std::uninitialized_move_n(other.Data(), other.size_, Data());
+            std::destroy_n(other.Data(), other.size_);
+        }
+        else
+        {
+            heap_.Swap(other.heap_);
+        }
+        size_ = std::exchange(other.size_, 0);
+    }
+
+    ~SmallVector()
+    {
+        std::destroy_n(Data(), size_);
+    }
+
+    SmallVector &operator=(const SmallVector &rhs)
+    {
+        if (this != &rhs)
+        {
+            if constexpr (AllocTraits::propagate_on_container_copy_assignment::value &&
+                          !AllocTraits::is_always_equal::value)
+            {
+                if (GetAllocator() != rhs.GetAllocator())
+                {
+                    // Наш буфер в куче может освободить только наш аллокатор: освобождаем его и
+                    // переходим на аллокатор rhs, даже если копия поместится во встроенный буфер
+                    std::destroy_n(Data(), size_);
+                    size_ = 0;
+                    heap_ = RawMemory<T, Alloc>(rhs.GetAllocator());
+                }
+            }
+            if (rhs.size_ > Capacity())
+            {
+                // Если не хватает capacity, копируем в новый буфер
+                RawMemory<T, Alloc> new_data(rhs.size_, GetAllocator());
+                std::uninitialized_copy_n(rhs.Data(), rhs.size_, new_data.GetAddress());
+                std::destroy_n(Data(), size_);
+                heap_ = std::move(new_data);
+                size_ = rhs.size_;
+            }
+            else
+            {
+                const size_t min_size = std::min(size_, rhs.size_);
+                std::copy_n(rhs.Data(), min_size, Data());
+                if (rhs.size_ > size_)
+                {
+                    std::uninitialized_copy_n(rhs.Data() + size_, rhs.size_ - size_, Data() + size_);
+                }
+                else
+                {
+                    std::destroy_n(Data() + rhs.size_, size_ - rhs.size_);
+                }
+                size_ = rhs.size_;
+            }
+        }
+        return *this;
+    }
+    SmallVector &operator=(SmallVector &&rhs) noexcept(PROPAGATE_ON_MOVE && std::is_nothrow_move_constructible_v<T>)
+    {
+        if (this == &rhs)
+        {
+            return *this;
+        }
+        std::destroy_n(Data(), size_);
+        size_ = 0;
+        const bool same_allocator = PROPAGATE_ON_MOVE || GetAllocator() == rhs.GetAllocator();
+        if (!rhs.IsInline() && same_allocator)
+        {
+            // Вместе с буфером забираем и аллокатор, которым он был выделен
+            heap_ = std::move(rhs.heap_);
+        }
+        else
+        {
+            if constexpr (AllocTraits::propagate_on_container_move_assignment::value &&
+                          !AllocTraits::is_always_equal::value)
+            {
+                // Наш буфер может освободить только наш аллокатор, затем переходим на аллокатор rhs
+                if (GetAllocator() != rhs.GetAllocator())
+                {
+                    heap_ = RawMemory<T, Alloc>(rhs.GetAllocator());
+                }
+            }
+            // Емкость любого SmallVector не меньше N, поэтому встроенные элементы rhs помещаются
+            // в наш буфер. Буфер rhs в куче чужого аллокатора забрать нельзя, элементы переносятся
+            Reserve(rhs.size_);
+            std::uninitialized_move_n(rhs.Data(), rhs.size_, Data());
+            std::destroy_n(rhs.Data(), rhs.size_);
+        }
+        size_ = std::exchange(rhs.size_, 0);
+        return *this;
+    }
+
+    // Если аллокатор не распространяется при обмене (propagate_on_container_swap == false),
+    // аллокаторы векторов должны быть равны
+    void Swap(SmallVector &other) noexcept(std::is_nothrow_move_constructible_v<T>)
+    {
+        if constexpr (!AllocTraits::propagate_on_container_swap::value && !AllocTraits::is_always_equal::value)
+        {
+            assert(GetAllocator() == other.GetAllocator());
+        }
+        if (IsInline() && other.IsInline())
+        {
+            SmallVector &longer = size_ >= other.size_ ? *this : other;
+            SmallVector &shorter = size_ >= other.size_ ? other : *this;
+            std::swap_ranges(shorter.Data(), shorter.Data() + shorter.size_, longer.Data());
+            std::uninitialized_move(longer.Data() + shorter.size_, longer.Data() + longer.size_,
+                                    shorter.Data() + shorter.size_);
+            std::destroy(longer.Data() + shorter.size_, longer.Data() + longer.size_);
+        }
+        else if (IsInline() || other.IsInline())
+        {
+            // Встроенные элементы переезжают во встроенный буфер вектора, отдающего буфер в куче
+            SmallVector &inline_side = IsInline() ? *this : other;
+            SmallVector &heap_side = IsInline() ? other : *this;
+            T *const to = reinterpret_cast<T *>(heap_side.inline_buffer_);
+            std::uninitialized_move_n(inline_side.Data(), inline_side.size_, to);
+            std::destroy_n(inline_side.Data(), inline_side.size_);
+        }
+        // Буферы в куче меняются вместе с аллокаторами
+        heap_.Swap(other.heap_);
+        std::swap(size_, other.size_);
+    }
+
+    const Alloc &GetAllocator() const noexcept
+    {
+        return heap_.GetAllocator();
+    }
+
+    // Элементы хранятся во встроенном буфере
+    bool IsInline() const noexcept
+    {
+        return heap_.GetAddress() == nullptr;
+    }
+
+    size_t Size() const noexcept
+    {
+        return size_;
+    }
+
+    size_t Capacity() const noexcept
+    {
+        return IsInline() ? N : heap_.Capacity();
+    }
+
+    void Reserve(size_t new_capacity)
+    {
+        if (new_capacity <= Capacity())
+        {
+            return;
+        }
+        RawMemory<T, Alloc> new_data(new_capacity, GetAllocator());
+        detail::RelocateN(Data(), size_, new_data.GetAddress());
+        heap_.Swap(new_data);
+    }
+
+    void Resize(size_t new_size)
+    {
+        if (size_ >= new_size)
+        {
+            std::destroy_n(Data() + new_size, size_ - new_size);
+        }
+        else
+        {
+            Reserve(new_size);
+            std::uninitialized_value_construct_n(Data() + size_, new_size - size_);
+        }
+        size_ = new_size;
+    }
+    void PushBack(const T &value)
+    {
+        EmplaceBack(value);
+    }
+    void PushBack(T &&value)
+    {
+        EmplaceBack(std::move(value));
+    }
+    void PopBack() noexcept
+    {
+        assert(size_ > 0);
+        std::destroy_at(Data() + size_ - 1);
+        --size_;
+    }
+    template <typename... Args>
+    T &EmplaceBack(Args &&...args)
+    {
+        return *Emplace(end(), std::forward<Args>(args)...);
+    }
+    const T &operator[](size_t index) const noexcept
+    {
+        return const_cast<SmallVector &>(*this)[index];
+    }
+
+    T &operator[](size_t index) noexcept
+    {
+        assert(index < size_);
+        return Data()[index];
+    }
+
+    using iterator = T *;
+    using const_iterator = const T *;
+
+    iterator begin() noexcept
+    {
+        return Data();
+    }
+    const_iterator begin() const noexcept
+    {
+        return Data();
+    }
+    const_iterator cbegin() const noexcept
+    {
+        return Data();
+    }
+    iterator end() noexcept
+    {
+        return Data() + size_;
+    }
+    const_iterator end() const noexcept
+    {
+        return Data() + size_;
+    }
+    const_iterator cend() const noexcept
+    {
+        return Data() + size_;
+    }
+
+    template <typename... Args>
+    iterator Emplace(const_iterator pos, Args &&...args)
+    {
+        assert(pos >= begin() && pos <= end());
+        const size_t offset = pos - begin();
+
+        if (size_ == Capacity())
+        {
+            EmplaceWithReallocation(offset, std::forward<Args>(args)...);
+        }
+        else
+        {
+            T *new_elem_pos = Data() + offset;
+            // Как в Vector::Emplace: сравнение offset >= size_ и сдвиг на tail элементов от
+            // new_elem_pos не дают компилятору выводить индексы за пределами буфера
+            if (offset >= size_)
+            {
+                new (new_elem_pos) T(std::forward<Args>(args)...);
+            }
+            else
+            {
+                T tmp_copy(std::forward<Args>(args)...);
+                const size_t tail = size_ - offset - 1;
+                new (new_elem_pos + tail + 1) T(std::move(new_elem_pos[tail]));
+                std::move_backward(new_elem_pos, new_elem_pos + tail, new_elem_pos + tail + 1);
+                *new_elem_pos = std::move(tmp_copy);
+            }
+        }
+        ++size_;
+        return begin() + offset;
+    }
+
+    iterator Erase(const_iterator pos)
+    {
+        assert(pos >= begin() && pos < end());
+        const size_t offset = pos - begin();
+        std::move(Data() + offset + 1, Data() + size_, Data() + offset);
+        std::destroy_at(Data() + size_ - 1);
+        --size_;
+        return Data() + offset;
+    }
+    iterator Insert(const_iterator pos, const T &value)
+    {
+        return Emplace(pos, value);
+    }
+    iterator Insert(const_iterator pos, T &&value)
+    {
+        return Emplace(pos, std::move(value));
+    }
+
+private:
+    T *Data() noexcept
+    {
+        if (IsInline())
+        {
+            // Во встроенном буфере помещается не больше N элементов
+            VECTOR_ASSUME(size_ <= N);
+            return reinterpret_cast<T *>(inline_buffer_);
+        }
+        return heap_.GetAddress();
+    }
+
+    const T *Data() const noexcept
+    {
+        return const_cast<SmallVector &>(*this).Data();
+    }
+
+    // Вставляет элемент в позицию offset заполненного вектора, перенося элементы в новый буфер.
+    // Новый элемент создается до переноса: аргументы могут ссылаться на элементы вектора
+    template <typename... Args>
+    void EmplaceWithReallocation(size_t offset, Args &&...args)
+    {
+        RawMemory<T, Alloc> new_data(Growth::NextCapacity(Capacity(), sizeof(T)), GetAllocator());
+        T *new_start = new_data.GetAddress();
+        new (new_start + offset) T(std::forward<Args>(args)...);
+
+        detail::RelocateAroundGap(Data(), size_, offset, 1, new_start);
+        heap_.Swap(new_data);
+    }
+
+    alignas(T) unsigned char inline_buffer_[N * sizeof(T)];
+    RawMemory<T, Alloc> heap_;
+    size_t size_ = 0;
+};
\ No newline at end of file
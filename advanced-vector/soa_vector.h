@@ -0,0 +1,431 @@
+#pragma once
+#include "vector.h"
+
+#include <array>
+#include <tuple>
+
+// Непрерывный диапазон элементов одного столбца SoAVector. Указатель и размер действительны
+// до первого изменения емкости контейнера
+template <typename T>
+using ColumnSpan = Span<T>;
+
+// Контейнер «структура массивов»: строка из полей Fields... хранится не одним объектом,
+// а по одному элементу в каждом из столбцов. Каждый столбец — отдельный RawMemory, поэтому
+// цикл по одному полю читает только его память. Столбцы растут вместе по политике Growth,
+// размер строки для политики — сумма размеров полей.
+// operator[] возвращает строку как кортеж ссылок на поля, что позволяет писать
+//     auto [position, velocity] = particles[i];
+// Вставка в конец дает строгую гарантию безопасности исключений, как и Vector::EmplaceBack
+// (для полей с выбрасывающим исключения перемещением без копирования — базовую)
+template <typename Growth, typename... Fields>
+class BasicSoAVector
+{
+    static_assert(sizeof...(Fields) > 0, "SoAVector requires at least one field");
+
+    static constexpr size_t COLUMNS = sizeof...(Fields);
+    static constexpr size_t ROW_SIZE = (sizeof(Fields) + ...);
+    static constexpr bool NOTHROW_ERASE = ((IsTriviallyRelocatableV<Fields> ||
+                                            std::is_nothrow_move_assignable_v<Fields>)&&...);
+
+    using Columns = std::tuple<RawMemory<Fields>...>;
+    using Indices = std::index_sequence_for<Fields...>;
+
+public:
+    template <size_t I>
+    using Field = std::tuple_element_t<I, std::tuple<Fields...>>;
+
+    using Value = std::tuple<Fields...>;
+    using Reference = std::tuple<Fields &...>;
+    using ConstReference = std::tuple<const Fields &...>;
+
+    // Итератор по строкам. Разыменование возвращает кортеж ссылок на поля строки
+    template <bool IS_CONST>
+    class RowIterator
+    {
+        using Owner = std::conditional_t<IS_CONST, const BasicSoAVector, BasicSoAVector>;
+
+    public:
+        using iterator_category = std::input_iterator_tag;
+        using value_type = Value;
+        using reference = std::conditional_t<IS_CONST, ConstReference, Reference>;
+        using pointer = void;
+        using difference_type = std::ptrdiff_t;
+
+        RowIterator(Owner *owner, size_t index) noexcept
+            : owner_(owner), index_(index)
+        {
+        }
+
+        reference operator*() const noexcept
+        {
+            return (*owner_)[index_];
+        }
+
+        RowIterator &operator++() noexcept
+        {
+            ++index_;
+            return *this;
+        }
+
+        RowIterator operator++(int) noexcept
+        {
+            RowIterator old = *this;
+            ++index_;
+            return old;
+        }
+
+        bool operator==(const RowIterator &other) const noexcept
+        {
+            return owner_ == other.owner_ && index_ == other.index_;
+        }
+
+        bool operator!=(const RowIterator &other) const noexcept
+        {
+            return !(*this == other);
+        }
+
+    private:
+        Owner *owner_;
+        size_t index_;
+    };
+
+    using iterator = RowIterator<false>;
+    using const_iterator = RowIterator<true>;
+
+    BasicSoAVector() = default;
+
+    BasicSoAVector(const BasicSoAVector &other)
+        : BasicSoAVector() //
+    {
+        Reserve(other.size_);
+        for (size_t i = 0; i < other.size_; ++i)
+        {
+            CopyRowFrom(other, i, Indices{});
+        }
+    }
+
+    BasicSoAVector(BasicSoAVector &&other) noexcept
+    {
+        Swap(other);
+    }
+
+    ~BasicSoAVector()
+    {
+        DestroyRows(0, size_);
+    }
+
+    BasicSoAVector &operator=(const BasicSoAVector &rhs)
+    {
+        if (this != &rhs)
+        {
+            BasicSoAVector(rhs).Swap(*this);
+        }
+        return *this;
+    }
+
+    BasicSoAVector &operator=(BasicSoAVector &&rhs) noexcept
+    {
+        if (this != &rhs)
+        {
+            Clear();
+            Swap(rhs);
+        }
+        return *this;
+    }
+
+    void Swap(BasicSoAVector &other) noexcept
+    {
+        ForEachColumn([this, &other](auto index)
+                      { std::get<decltype(index)::value>(columns_).Swap(std::get<decltype(index)::value>(other.columns_)); });
+        std::swap(size_, other.size_);
+    }
+
+    size_t Size() const noexcept
+    {
+        return size_;
+    }
+
+    size_t Capacity() const noexcept
+    {
+        return std::get<0>(columns_).Capacity();
+    }
+
+    void Reserve(size_t new_capacity)
+    {
+        if (new_capacity <= Capacity())
+        {
+            return;
+        }
+        Columns new_columns = AllocateColumns(new_capacity, Indices{});
+        TransferColumns(new_columns);
+        columns_.swap(new_columns);
+    }
+
+    void Clear() noexcept
+    {
+        DestroyRows(0, size_);
+        size_ = 0;
+    }
+
+    // Добавляет строку, создавая каждое поле из соответствующего аргумента
+    template <typename... Args>
+    Reference EmplaceBack(Args &&...args)
+    {
+        static_assert(sizeof...(Args) == COLUMNS, "EmplaceBack takes one argument per field");
+        if (size_ == Capacity())
+        {
+            // Новая строка создается до переноса: аргументы могут ссылаться на элементы контейнера
+            const size_t new_capacity = Growth::NextCapacity(Capacity(), ROW_SIZE);
+            Columns new_columns = AllocateColumns(new_capacity, Indices{});
+            ConstructRow(new_columns, size_, Indices{}, std::forward<Args>(args)...);
+            try
+            {
+                TransferColumns(new_columns);
+            }
+            catch (...)
+            {
+                DestroyRow(new_columns, size_);
+                throw;
+            }
+            columns_.swap(new_columns);
+        }
+        else
+        {
+            ConstructRow(columns_, size_, Indices{}, std::forward<Args>(args)...);
+        }
+        ++size_;
+        return (*this)[size_ - 1];
+    }
+
+    void PopBack() noexcept
+    {
+        assert(size_ > 0);
+        DestroyRows(size_ - 1, size_);
+        --size_;
+    }
+
+    // Удаляет строки [first, last), сдвигая хвост каждого столбца. Тривиально перемещаемые
+    // поля сдвигаются побайтово, остальные — перемещающим присваиванием. Если оно выбросит
+    // исключение, строки контейнера могут оказаться сдвинутыми не во всех столбцах
+    void Erase(size_t first, size_t last) noexcept(NOTHROW_ERASE)
+    {
+        assert(first <= last && last <= size_);
+        const size_t count = last - first;
+        if (count == 0)
+        {
+            return;
+        }
+        ForEachColumn([this, first, count](auto index)
+                      {
+                          using T = Field<decltype(index)::value>;
+                          T *const data = std::get<decltype(index)::value>(columns_).GetAddress();
+                          if constexpr (IsTriviallyRelocatableV<T>)
+                          {
+                              std::destroy_n(data + first, count);
+                              std::memmove(static_cast<void *>(data + first), static_cast<const void *>(data + first + count),
+                                           (size_ - first - count) * sizeof(T));
+                          }
+                          else
+                          {
+                              std::move(data + first + count, data + size_, data + first);
+                              std::destroy_n(data + size_ - count, count);
+                          } });
+        size_ -= count;
+    }
+
+    void Erase(size_t index) noexcept(NOTHROW_ERASE)
+    {
+        assert(index < size_);
+        Erase(index, index + 1);
+    }
+
+    Reference operator[](size_t index) noexcept
+    {
+        assert(index < size_);
+        return RowAt(index, Indices{});
+    }
+
+    ConstReference operator[](size_t index) const noexcept
+    {
+        assert(index < size_);
+        return RowAt(index, Indices{});
+    }
+
+    template <size_t I>
+    Field<I> &Get(size_t index) noexcept
+    {
+        assert(index < size_);
+        return std::get<I>(columns_)[index];
+    }
+
+    template <size_t I>
+    const Field<I> &Get(size_t index) const noexcept
+    {
+        assert(index < size_);
+        return std::get<I>(columns_)[index];
+    }
+
+    // Все элементы I-го поля подряд в памяти
+    template <size_t I>
+    ColumnSpan<Field<I>> Column() noexcept
+    {
+        return {std::get<I>(columns_).GetAddress(), size_};
+    }
+
+    template <size_t I>
+    ColumnSpan<const Field<I>> Column() const noexcept
+    {
+        return {std::get<I>(columns_).GetAddress(), size_};
+    }
+
+    iterator begin() noexcept
+    {
+        return {this, 0};
+    }
+    const_iterator begin() const noexcept
+    {
+        return {this, 0};
+    }
+    const_iterator cbegin() const noexcept
+    {
+        return begin();
+    }
+    iterator end() noexcept
+    {
+        return {this, size_};
+    }
+    const_iterator end() const noexcept
+    {
+        return {this, size_};
+    }
+    const_iterator cend() const noexcept
+    {
+        return end();
+    }
+
+private:
+    // Поле переносится в новый буфер копированием либо выбрасывающим исключения перемещением
+    template <typename T>
+    static constexpr bool MAY_THROW_ON_TRANSFER = !IsTriviallyRelocatableV<T> &&
+                                                  !std::is_nothrow_move_constructible_v<T>;
+
+    // Вызывает f(std::integral_constant<size_t, I>{}) для каждого столбца по порядку
+    template <typename F>
+    static void ForEachColumn(F &&f)
+    {
+        ForEachColumnImpl(f, Indices{});
+    }
+
+    template <typename F, size_t... Is>
+    static void ForEachColumnImpl(F &f, std::index_sequence<Is...>)
+    {
+        (f(std::integral_constant<size_t, Is>{}), ...);
+    }
+
+    template <size_t... Is>
+    static Columns AllocateColumns(size_t capacity, std::index_sequence<Is...>)
+    {
+        return Columns(RawMemory<Fields>(capacity)...);
+    }
+
+    template <size_t... Is>
+    Reference RowAt(size_t index, std::index_sequence<Is...>) noexcept
+    {
+        return Reference(std::get<Is>(columns_)[index]...);
+    }
+
+    template <size_t... Is>
+    ConstReference RowAt(size_t index, std::index_sequence<Is...>) const noexcept
+    {
+        return ConstReference(std::get<Is>(columns_)[index]...);
+    }
+
+    template <size_t... Is>
+    void CopyRowFrom(const BasicSoAVector &other, size_t index, std::index_sequence<Is...>)
+    {
+        EmplaceBack(std::get<Is>(other.columns_)[index]...);
+    }
+
+    // Создает поля строки pos в columns. Если конструктор поля выбросит исключение,
+    // уже созданные поля строки уничтожаются
+    template <size_t... Is, typename... Args>
+    static void ConstructRow(Columns &columns, size_t pos, std::index_sequence<Is...>, Args &&...args)
+    {
+        std::array<bool, COLUMNS> constructed{};
+        try
+        {
+            ((new (std::get<Is>(columns) + pos) Field<Is>(std::forward<Args>(args)), constructed[Is] = true), ...);
+        }
+        catch (...)
+        {
+            ForEachColumn([&columns, pos, &constructed](auto index)
+                          {
+                              if (constructed[decltype(index)::value])
+                              {
+                                  std::destroy_at(std::get<decltype(index)::value>(columns) + pos);
+                              } });
+            throw;
+        }
+    }
+
+    static void DestroyRow(Columns &columns, size_t pos) noexcept
+    {
+        ForEachColumn([&columns, pos](auto index)
+                      { std::destroy_at(std::get<decltype(index)::value>(columns) + pos); });
+    }
+
+    void DestroyRows(size_t first, size_t last) noexcept
+    {
+        ForEachColumn([this, first, last](auto index)
+                      { std::destroy(std::get<decltype(index)::value>(columns_) + first,
+                                     std::get<decltype(index)::value>(columns_) + last); });
+    }
+
+    // Переносит строки в новые столбцы. Сначала создаются копии полей, чей перенос может
+    // выбросить исключение: при неудаче они уничтожаются, а исходные столбцы остаются
+    // нетронутыми. Остальные поля переносятся уже без риска исключений
+    void TransferColumns(Columns &to)
+    {
+        std::array<bool, COLUMNS> transferred{};
+        try
+        {
+            ForEachColumn([this, &to, &transferred](auto index)
+                          {
+                              constexpr size_t I = decltype(index)::value;
+                              if constexpr (MAY_THROW_ON_TRANSFER<Field<I>>)
+                              {
+                                  detail::UninitializedMoveOrCopyN(std::get<I>(columns_).GetAddress(), size_,
+                                                                   std::get<I>(to).GetAddress());
+                                  transferred[I] = true;
+                              } });
+        }
+        catch (...)
+        {
+            ForEachColumn([&to, &transferred, this](auto index)
+                          {
+                              if (transferred[decltype(index)::value])
+                              {
+                                  std::destroy_n(std::get<decltype(index)::value>(to).GetAddress(), size_);
+                              } });
+            throw;
+        }
+        ForEachColumn([this, &to](auto index)
+                      {
+                          constexpr size_t I = decltype(index)::value;
+                          RawMemory<Field<I>> &from = std::get<I>(columns_);
+                          if constexpr (MAY_THROW_ON_TRANSFER<Field<I>>)
+                          {
+                              std::destroy_n(from.GetAddress(), size_);
+                          }
+                          else
+                          {
+                              detail::RelocateN(from.GetAddress(), size_, std::get<I>(to).GetAddress());
+                          } });
+    }
+
+    Columns columns_;
+    size_t size_ = 0;
+};
+
+template <typename... Fields>
+using SoAVector = BasicSoAVector<DoublingGrowth, Fields...>;
\ No newline at end of file
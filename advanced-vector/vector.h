@@ -1,358 +1,1743 @@
 #pragma once
 #include <algorithm>
+#include <atomic>
 #include <cassert>
+#include <cstddef>
+#include <cstdio>
 #include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <functional>
+#include <iterator>
 #include <new>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
 #include <utility>
 #include <memory>
 
+// Начиная с C++20 основные операции Vector и RawMemory доступны в constexpr-вычислениях:
+// память выделяется через std::allocator_traits, элементы создаются std::construct_at.
+// В C++17 макрос VECTOR_CONSTEXPR пуст
+#if __cplusplus >= 202002L && defined(__cpp_constexpr_dynamic_alloc)
+#define VECTOR_HAS_CONSTEXPR 1
+#define VECTOR_CONSTEXPR constexpr
+#else
+#define VECTOR_HAS_CONSTEXPR 0
+#define VECTOR_CONSTEXPR
+#endif
+
+// Подсказка компилятору, что условие почти всегда ложно: проверка остается одним сравнением,
+// а ветка обработки ошибки выносится из горячего пути
+#if defined(__GNUC__)
+#define VECTOR_UNLIKELY(condition) __builtin_expect(!!(condition), 0)
+#else
+#define VECTOR_UNLIKELY(condition) (condition)
+#endif
+
+// Сообщает компилятору инвариант, который тот не может вывести сам, чтобы он не строил код
+// и не выдавал предупреждения для невозможных путей. Нарушение инварианта — неопределенное поведение
+#if defined(__GNUC__)
+#define VECTOR_ASSUME(condition) ((condition) ? void(0) : __builtin_unreachable())
+#else
+#define VECTOR_ASSUME(condition) void(0)
+#endif
+
+// Признак того, что объект типа T можно перенести в другую память побайтовым копированием,
+// не вызывая конструктор перемещения и деструктор исходного объекта.
+// По умолчанию истинен для тривиально копируемых типов. Для собственных типов (например,
+// владеющих дескрипторов, не хранящих указателей на себя) можно объявить специализацию:
+//     template <>
+//     struct IsTriviallyRelocatable<MyHandle> : std::true_type {};
 template <typename T>
-class RawMemory
+struct IsTriviallyRelocatable : std::is_trivially_copyable<T>
 {
-public:
-    RawMemory() = default;
+};
+
+template <typename T>
+inline constexpr bool IsTriviallyRelocatableV = IsTriviallyRelocatable<T>::value;
+
+// Политика копирующего присваивания в вектор недостаточной емкости. Если true, старый буфер
+// освобождается до выделения нового: пиковый расход памяти меньше, но при исключении вектор
+// остается пустым (базовая гарантия вместо строгой). По умолчанию включено для тривиально
+// копируемых типов, копирование которых не выбрасывает исключений. Для своего типа можно
+// объявить специализацию:
+//     template <>
+//     struct ReleaseBeforeCopyAssign<MyType> : std::false_type {};
+template <typename T>
+struct ReleaseBeforeCopyAssign : std::is_trivially_copyable<T>
+{
+};
+
+template <typename T>
+inline constexpr bool ReleaseBeforeCopyAssignV = ReleaseBeforeCopyAssign<T>::value;
 
-    explicit RawMemory(size_t capacity)
-        : buffer_(Allocate(capacity)), capacity_(capacity)
+namespace detail
+{
+    // Вычисляется ли выражение на этапе компиляции. До C++20 всегда false
+    constexpr bool IsConstantEvaluated() noexcept
     {
+#if VECTOR_HAS_CONSTEXPR
+        return std::is_constant_evaluated();
+#else
+        return false;
+#endif
     }
 
-    ~RawMemory()
+    // Создает объект по адресу p. В C++20 — через std::construct_at, допустимый в constexpr
+    template <typename T, typename... Args>
+    VECTOR_CONSTEXPR T *ConstructAt(T *p, Args &&...args)
     {
-        Deallocate(buffer_);
-        capacity_ = 0;
+#if VECTOR_HAS_CONSTEXPR
+        return std::construct_at(p, std::forward<Args>(args)...);
+#else
+        return new (static_cast<void *>(p)) T(std::forward<Args>(args)...);
+#endif
     }
 
-    RawMemory(const RawMemory &) = delete;
-    RawMemory &operator=(const RawMemory &rhs) = delete;
-    RawMemory(RawMemory &&other) noexcept
-        : buffer_(std::move(other.buffer_)),
-          capacity_(other.capacity_)
+    // Аналоги std::uninitialized_value_construct_n и std::uninitialized_copy_n, допустимые
+    // в constexpr-вычислениях. Исключение на этапе компиляции прерывает вычисление целиком,
+    // поэтому откат уже созданных элементов там не нужен
+    template <typename T>
+    VECTOR_CONSTEXPR void UninitializedValueConstructN(T *to, size_t n)
     {
-        other.buffer_ = nullptr;
-        other.capacity_ = 0;
+        if (IsConstantEvaluated())
+        {
+            for (size_t i = 0; i < n; ++i)
+            {
+                ConstructAt(to + i);
+            }
+            return;
+        }
+        std::uninitialized_value_construct_n(to, n);
     }
-    RawMemory &operator=(RawMemory &&rhs) noexcept
+
+    template <typename InputIt, typename T>
+    VECTOR_CONSTEXPR T *UninitializedCopyN(InputIt from, size_t n, T *to)
     {
-        if (this != &rhs)
+        if (IsConstantEvaluated())
         {
-            Deallocate(buffer_);
-            buffer_ = std::move(rhs.buffer_);
-            capacity_ = std::move(rhs.capacity_);
-
-            rhs.buffer_ = nullptr;
-            rhs.capacity_ = 0;
+            for (size_t i = 0; i < n; ++i, ++from)
+            {
+                ConstructAt(to + i, *from);
+            }
+            return to + n;
         }
-        return *this;
+        return std::uninitialized_copy_n(from, n, to);
     }
 
-    T *operator+(size_t offset) noexcept
+    // Аллокатор умеет расширять выделенный блок на месте: bool try_expand(T *p, size_t old_n, size_t new_n)
+    template <typename Alloc, typename = void>
+    struct HasTryExpand : std::false_type
     {
-        // Разрешается получать адрес ячейки памяти, следующей за последним элементом массива
-        assert(offset <= capacity_);
-        return buffer_ + offset;
-    }
+    };
 
-    const T *operator+(size_t offset) const noexcept
+    template <typename Alloc>
+    struct HasTryExpand<Alloc, std::void_t<decltype(std::declval<Alloc &>().try_expand(
+                                   std::declval<typename Alloc::value_type *>(), size_t{}, size_t{}))>>
+        : std::true_type
     {
-        return const_cast<RawMemory &>(*this) + offset;
-    }
+    };
 
-    const T &operator[](size_t index) const noexcept
+    // Аллокатор умеет изменять размер блока с сохранением содержимого, возможно перенося его
+    // по другому адресу: T *reallocate(T *p, size_t old_n, size_t new_n)
+    template <typename Alloc, typename = void>
+    struct HasReallocate : std::false_type
     {
-        return const_cast<RawMemory &>(*this)[index];
+    };
+
+    template <typename Alloc>
+    struct HasReallocate<Alloc, std::void_t<decltype(std::declval<Alloc &>().reallocate(
+                                    std::declval<typename Alloc::value_type *>(), size_t{}, size_t{}))>>
+        : std::true_type
+    {
+    };
+
+    // Перемещает n элементов из from в неинициализированную память to, если перемещение
+    // не выбрасывает исключений или тип не копируем, иначе копирует их. Возвращает конец
+    // созданного диапазона. При исключении уже созданные элементы уничтожаются
+    template <typename T>
+    VECTOR_CONSTEXPR T *UninitializedMoveOrCopyN(T *from, size_t n, T *to)
+    {
+        if (IsConstantEvaluated())
+        {
+            for (size_t i = 0; i < n; ++i)
+            {
+                ConstructAt(to + i, std::move(from[i]));
+            }
+            return to + n;
+        }
+        if constexpr (std::is_nothrow_move_constructible_v<T> || !std::is_copy_constructible_v<T>)
+        {
+            return std::uninitialized_move_n(from, n, to).second;
+        }
+        else
+        {
+            return std::uninitialized_copy_n(from, n, to);
+        }
     }
 
-    T &operator[](size_t index) noexcept
+    // Переносит n элементов из from в неинициализированную память to и уничтожает исходные.
+    // Тривиально перемещаемые типы переносятся одним memcpy без вызова деструкторов.
+    // Если конструктор копирования выбросит исключение, исходные элементы остаются нетронутыми
+    template <typename T>
+    VECTOR_CONSTEXPR void RelocateN(T *from, size_t n, T *to)
     {
-        assert(index < capacity_);
-        return buffer_[index];
+        if (IsConstantEvaluated())
+        {
+            UninitializedMoveOrCopyN(from, n, to);
+            std::destroy_n(from, n);
+        }
+        else if constexpr (IsTriviallyRelocatableV<T>)
+        {
+            if (n != 0)
+            {
+                std::memcpy(static_cast<void *>(to), static_cast<const void *>(from), n * sizeof(T));
+            }
+        }
+        else
+        {
+            UninitializedMoveOrCopyN(from, n, to);
+            std::destroy_n(from, n);
+        }
     }
 
-    void Swap(RawMemory &other) noexcept
+    // Переносит size элементов из from в to, оставляя после первых offset элементов промежуток
+    // из gap элементов, уже созданных в to. При успехе исходные элементы уничтожаются.
+    // При исключении уничтожаются все элементы, созданные в to (включая промежуток),
+    // а исходные остаются нетронутыми
+    template <typename T>
+    void RelocateAroundGap(T *from, size_t size, size_t offset, size_t gap, T *to)
     {
-        std::swap(buffer_, other.buffer_);
-        std::swap(capacity_, other.capacity_);
+        if constexpr (IsTriviallyRelocatableV<T>)
+        {
+            RelocateN(from, offset, to);
+            RelocateN(from + offset, size - offset, to + offset + gap);
+        }
+        else
+        {
+            try
+            {
+                UninitializedMoveOrCopyN(from, offset, to);
+            }
+            catch (...)
+            {
+                std::destroy_n(to + offset, gap);
+                throw;
+            }
+            try
+            {
+                UninitializedMoveOrCopyN(from + offset, size - offset, to + offset + gap);
+            }
+            catch (...)
+            {
+                std::destroy_n(to, offset + gap);
+                throw;
+            }
+            std::destroy_n(from, size);
+        }
     }
 
-    const T *GetAddress() const noexcept
+    template <typename It>
+    using RequireInputIterator = std::enable_if_t<
+        std::is_convertible_v<typename std::iterator_traits<It>::iterator_category, std::input_iterator_tag>>;
+
+    template <typename It>
+    inline constexpr bool IS_FORWARD_ITERATOR =
+        std::is_convertible_v<typename std::iterator_traits<It>::iterator_category, std::forward_iterator_tag>;
+
+    // Однонаправленный итератор, на каждой позиции возвращающий одно и то же значение.
+    // Позволяет выразить вставку n копий значения через вставку диапазона
+    template <typename T>
+    class RepeatIterator
+    {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const T *;
+        using reference = const T &;
+
+        RepeatIterator() = default;
+
+        explicit RepeatIterator(const T &value, difference_type index = 0) noexcept
+            : value_(&value), index_(index)
+        {
+        }
+
+        reference operator*() const noexcept
+        {
+            return *value_;
+        }
+
+        pointer operator->() const noexcept
+        {
+            return value_;
+        }
+
+        RepeatIterator &operator++() noexcept
+        {
+            ++index_;
+            return *this;
+        }
+
+        RepeatIterator operator++(int) noexcept
+        {
+            RepeatIterator copy = *this;
+            ++index_;
+            return copy;
+        }
+
+        bool operator==(const RepeatIterator &other) const noexcept
+        {
+            return index_ == other.index_;
+        }
+
+        bool operator!=(const RepeatIterator &other) const noexcept
+        {
+            return index_ != other.index_;
+        }
+
+    private:
+        const T *value_ = nullptr;
+        difference_type index_ = 0;
+    };
+} // namespace detail
+
+// Аллокатор на основе malloc/realloc/free.
+// Позволяет вектору тривиально перемещаемых элементов расти через realloc: аллокатор libc
+// может расширить блок на месте, а большие блоки переотображает (mremap) без копирования страниц
+template <typename T>
+struct MallocAllocator
+{
+    static_assert(alignof(T) <= alignof(std::max_align_t), "MallocAllocator does not support over-aligned types");
+
+    using value_type = T;
+    using is_always_equal = std::true_type;
+
+    MallocAllocator() = default;
+
+    template <typename U>
+    MallocAllocator(const MallocAllocator<U> & /*other*/) noexcept
     {
-        return buffer_;
     }
 
-    T *GetAddress() noexcept
+    T *allocate(size_t n)
     {
-        return buffer_;
+        void *p = std::malloc(n * sizeof(T));
+        if (p == nullptr)
+        {
+            throw std::bad_alloc();
+        }
+        return static_cast<T *>(p);
     }
 
-    size_t Capacity() const
+    void deallocate(T *p, size_t /*n*/) noexcept
     {
-        return capacity_;
+        std::free(p);
     }
 
-private:
-    // Выделяет сырую память под n элементов и возвращает указатель на неё
-    static T *Allocate(size_t n)
+    // При неудаче выбрасывает std::bad_alloc, исходный блок остается действительным
+    T *reallocate(T *p, size_t /*old_n*/, size_t new_n)
     {
-        return n != 0 ? static_cast<T *>(operator new(n * sizeof(T))) : nullptr;
+        void *new_p = std::realloc(p, new_n * sizeof(T));
+        if (new_p == nullptr)
+        {
+            throw std::bad_alloc();
+        }
+        return static_cast<T *>(new_p);
     }
 
-    // Освобождает сырую память, выделенную ранее по адресу buf при помощи Allocate
-    static void Deallocate(T *buf) noexcept
+    template <typename U>
+    bool operator==(const MallocAllocator<U> & /*other*/) const noexcept
     {
-        operator delete(buf);
+        return true;
     }
 
-    T *buffer_ = nullptr;
-    size_t capacity_ = 0;
+    template <typename U>
+    bool operator!=(const MallocAllocator<U> & /*other*/) const noexcept
+    {
+        return false;
+    }
 };
 
-template <typename T>
-class Vector
+// Аллокатор, выравнивающий буфер по границе ALIGNMENT байт (но не меньше alignof(T)).
+// Размер блока округляется вверх до кратного ALIGNMENT, поэтому векторные инструкции могут
+// читать последний неполный блок данных, не выходя за пределы выделенной памяти.
+// std::allocator и так выравнивает память для типов с повышенным выравниванием (alignas),
+// этот аллокатор нужен, чтобы выровнять буфер сильнее, чем требует сам тип
+template <typename T, size_t ALIGNMENT>
+struct AlignedAllocator
 {
-public:
-    Vector() = default;
+    static_assert((ALIGNMENT & (ALIGNMENT - 1)) == 0, "ALIGNMENT must be a power of two");
+
+    static constexpr size_t BUFFER_ALIGNMENT = std::max(ALIGNMENT, alignof(T));
+
+    using value_type = T;
+    using is_always_equal = std::true_type;
+
+    template <typename U>
+    struct rebind
+    {
+        using other = AlignedAllocator<U, ALIGNMENT>;
+    };
+
+    AlignedAllocator() = default;
 
-    explicit Vector(size_t size)
-        : data_(size), size_(size) //
+    template <typename U>
+    AlignedAllocator(const AlignedAllocator<U, ALIGNMENT> & /*other*/) noexcept
     {
-        std::uninitialized_value_construct_n(data_.GetAddress(), size);
     }
-    Vector(const Vector &other)
-        : data_(other.size_), size_(other.size_) //
+
+    T *allocate(size_t n)
     {
-        std::uninitialized_copy_n(other.data_.GetAddress(), other.size_, data_.GetAddress());
+        return static_cast<T *>(operator new(BufferSize(n), std::align_val_t{BUFFER_ALIGNMENT}));
     }
-    Vector(Vector &&other) noexcept
-        : data_(std::move(other.data_)), size_(other.size_)
+
+    void deallocate(T *p, size_t n) noexcept
     {
-        other.size_ = 0;
+        operator delete(p, BufferSize(n), std::align_val_t{BUFFER_ALIGNMENT});
     }
 
-    ~Vector()
+    template <typename U>
+    bool operator==(const AlignedAllocator<U, ALIGNMENT> & /*other*/) const noexcept
     {
-        std::destroy_n(data_.GetAddress(), size_);
+        return true;
     }
-    size_t Size() const noexcept
+
+    template <typename U>
+    bool operator!=(const AlignedAllocator<U, ALIGNMENT> & /*other*/) const noexcept
     {
-        return size_;
+        return false;
     }
 
-    Vector &operator=(const Vector &rhs)
+private:
+    static size_t BufferSize(size_t n) noexcept
     {
-        if (this != &rhs)
-        {
-            if (rhs.size_ > data_.Capacity())
-            {
-                // Если не хватает capacity, просто создаем новую копию
-                Vector(rhs).Swap(*this);
-            }
-            else
-            {
-                // Копируем элементы из rhs
-                const size_t min_size = std::min(size_, rhs.size_);
+        return (n * sizeof(T) + BUFFER_ALIGNMENT - 1) & ~(BUFFER_ALIGNMENT - 1);
+    }
+};
 
-                // Копируем общую часть
-                for (size_t i = 0; i < min_size; ++i)
-                {
-                    data_[i] = rhs.data_[i];
-                }
+// Аллокатор для векторов, созданных из внешнего буфера (см. Vector::Adopt).
+// Внешний буфер освобождается вызовом deleter(buffer), остальные буферы выделяются
+// и освобождаются std::allocator. Копии аллокатора разделяют сведения о внешнем буфере,
+// поэтому освободить его может любая из них, и только один раз. Аллокаторы равны, только
+// если это копии одного аллокатора, и переходят вместе с буфером при перемещении и обмене
+template <typename T>
+class ExternalBufferAllocator
+{
+    struct External
+    {
+        T *buffer;
+        std::function<void(T *)> deleter;
+    };
 
-                if (rhs.size_ > size_)
-                {
-                    // Если rhs больше - копируем оставшиеся элементы
-                    std::uninitialized_copy_n(
-                        rhs.data_.GetAddress() + size_,
-                        rhs.size_ - size_,
-                        data_.GetAddress() + size_);
-                }
-                else
-                {
-                    // Если rhs меньше - уничтожаем лишние элементы
-                    std::destroy_n(
-                        data_.GetAddress() + rhs.size_,
-                        size_ - rhs.size_);
-                }
+public:
+    using value_type = T;
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap = std::true_type;
+    using is_always_equal = std::false_type;
 
-                size_ = rhs.size_;
-            }
-        }
-        return *this;
-    }
-    Vector &operator=(Vector &&rhs) noexcept
-    {
-        Swap(rhs);
+    template <typename U>
+    friend class ExternalBufferAllocator;
 
-        return *this;
+    ExternalBufferAllocator() = default;
+
+    ExternalBufferAllocator(T *buffer, std::function<void(T *)> deleter)
+        : external_(std::make_shared<External>(External{buffer, std::move(deleter)}))
+    {
     }
 
-    void Swap(Vector &other) noexcept
+    // Внешний буфер принадлежит только аллокатору своего типа
+    template <typename U>
+    ExternalBufferAllocator(const ExternalBufferAllocator<U> & /*other*/) noexcept
     {
-        data_.Swap(other.data_);
-        std::swap(size_, other.size_);
     }
 
-    size_t Capacity() const noexcept
+    // Копия вектора размещается в собственной памяти и не ссылается на внешний буфер
+    ExternalBufferAllocator select_on_container_copy_construction() const noexcept
     {
-        return data_.Capacity();
+        return ExternalBufferAllocator();
     }
-    void Reserve(size_t new_capacity)
+
+    T *allocate(size_t n)
     {
-        if (new_capacity <= data_.Capacity())
-        {
-            return;
-        }
-        RawMemory<T> new_data(new_capacity);
-        if constexpr (std::is_nothrow_move_constructible_v<T> || !std::is_copy_constructible_v<T>)
-        {
-            std::uninitialized_move_n(data_.GetAddress(), size_, new_data.GetAddress());
-        }
-        else
-        {
-            std::uninitialized_copy_n(data_.GetAddress(), size_, new_data.GetAddress());
-        }
-        std::destroy_n(data_.GetAddress(), size_);
-        data_.Swap(new_data);
+        return std::allocator<T>().allocate(n);
     }
 
-    void Resize(size_t new_size)
+    void deallocate(T *p, size_t n) noexcept
     {
-        if (size_ >= new_size)
+        if (external_ && external_->buffer == p)
         {
-            std::destroy_n(data_.GetAddress() + new_size, size_ - new_size);
-            size_ = new_size;
+            external_->buffer = nullptr;
+            external_->deleter(p);
         }
         else
         {
-            Reserve(new_size);
-            std::uninitialized_default_construct_n(data_.GetAddress() + size_, new_size - size_);
-            size_ = new_size;
+            // GCC при -O3 не может доказать, что внешний буфер всегда попадает в ветку выше,
+            // и ложно предупреждает об освобождении памяти из malloc через operator delete
+#if defined(__GNUC__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+            std::allocator<T>().deallocate(p, n);
+#if defined(__GNUC__)
+#pragma GCC diagnostic pop
+#endif
         }
     }
-    void PushBack(const T &value)
-    {
-        EmplaceBack(value);
-    }
-    void PushBack(T &&value)
+
+    // Внешний буфер может освободить только аллокатор, который разделяет сведения о нем
+    bool operator==(const ExternalBufferAllocator &other) const noexcept
     {
-        EmplaceBack(std::move(value));
+        return external_ == other.external_;
     }
-    void PopBack() noexcept
+
+    bool operator!=(const ExternalBufferAllocator &other) const noexcept
     {
-        assert(size_ > 0);
-        std::destroy_at(data_.GetAddress() + size_ - 1);
-        --size_;
+        return !(*this == other);
     }
-    template <typename... Args>
-    T &EmplaceBack(Args &&...args)
+
+private:
+    std::shared_ptr<External> external_;
+};
+
+// Политики роста вектора. Метод NextCapacity возвращает емкость, которую получит заполненный
+// вектор емкости capacity с элементами размера element_size. Результат всегда больше capacity
+
+// Удвоение емкости
+struct DoublingGrowth
+{
+    static constexpr size_t NextCapacity(size_t capacity, size_t /*element_size*/) noexcept
     {
-        return *Emplace(end(), std::forward<Args>(args)...);
+        return std::max(size_t(1), capacity * 2);
     }
-    const T &operator[](size_t index) const noexcept
+};
+
+// Рост в 1.5 раза: суммарный размер ранее освобожденных блоков со временем превышает запрошенный,
+// и аллокатор может переиспользовать их для нового буфера
+struct OneAndHalfGrowth
+{
+    static constexpr size_t NextCapacity(size_t capacity, size_t /*element_size*/) noexcept
     {
-        return const_cast<Vector &>(*this)[index];
+        return std::max(capacity + 1, capacity + capacity / 2);
     }
+};
 
-    T &operator[](size_t index) noexcept
+// Рост по политике Base с округлением размера буфера вверх до класса размеров аллокатора:
+// небольшие блоки округляются до степени двойки (не меньше MIN_BLOCK байт), крупные — до
+// целого числа страниц PAGE_SIZE. Так в емкость вектора попадает память, которую аллокатор
+// всё равно выделил бы
+template <typename Base = OneAndHalfGrowth, size_t PAGE_SIZE = 4096, size_t MIN_BLOCK = 16>
+struct SizeClassGrowth
+{
+    static_assert((PAGE_SIZE & (PAGE_SIZE - 1)) == 0, "PAGE_SIZE must be a power of two");
+
+    static constexpr size_t NextCapacity(size_t capacity, size_t element_size) noexcept
     {
-        assert(index < size_);
-        return *(data_.GetAddress() + index);
+        const size_t min_bytes = Base::NextCapacity(capacity, element_size) * element_size;
+        size_t bytes = MIN_BLOCK;
+        if (min_bytes >= PAGE_SIZE)
+        {
+            bytes = (min_bytes + PAGE_SIZE - 1) & ~(PAGE_SIZE - 1);
+        }
+        else
+        {
+            while (bytes < min_bytes)
+            {
+                bytes *= 2;
+            }
+        }
+        return std::max(capacity + 1, bytes / element_size);
     }
+};
 
-    using iterator = T *;
-    using const_iterator = const T *;
+// Политики сбора статистики работы с памятью. Политика вызывается вектором и RawMemory
+// в следующих случаях:
+//     OnAllocate(bytes)                  — аллокатор выделил (или расширил блок на) bytes байт;
+//     OnCapacity(capacity)               — емкость буфера стала равной capacity элементов;
+//     OnReallocate(moved, copied, bytes) — при росте вектора элементы перенесены в новый буфер:
+//                                          moved перемещено, copied скопировано (конструктор
+//                                          перемещения может выбросить исключение), bytes — их
+//                                          суммарный размер.
+// Собственная политика с такими же статическими методами позволяет передавать события
+// напрямую в систему метрик
 
-    iterator begin() noexcept
+// Статистика не собирается, вызовы удаляются компилятором
+struct NoStats
+{
+    static constexpr void OnAllocate(size_t /*bytes*/) noexcept
     {
-        return data_.GetAddress();
     }
-    const_iterator begin() const noexcept
+
+    static constexpr void OnCapacity(size_t /*capacity*/) noexcept
     {
-        return data_.GetAddress();
     }
-    const_iterator cbegin() const noexcept
+
+    static constexpr void OnReallocate(size_t /*moved*/, size_t /*copied*/, size_t /*bytes*/) noexcept
     {
-        return data_.GetAddress();
     }
-    iterator end() noexcept
+};
+
+struct VectorStatsSnapshot
+{
+    size_t allocations = 0;
+    size_t allocated_bytes = 0;
+    size_t reallocations = 0;
+    size_t moved_elements = 0;
+    size_t copied_elements = 0;
+    size_t relocated_bytes = 0;
+    size_t peak_capacity = 0;
+};
+
+// Потокобезопасные счетчики, общие для всех векторов с одинаковым тегом Tag.
+// Разные теги позволяют вести отдельную статистику для разных подсистем
+template <typename Tag = void>
+class CountingStats
+{
+public:
+    static void OnAllocate(size_t bytes) noexcept
     {
-        return data_.GetAddress() + size_;
+        allocations_.fetch_add(1, std::memory_order_relaxed);
+        allocated_bytes_.fetch_add(bytes, std::memory_order_relaxed);
     }
-    const_iterator end() const noexcept
+
+    static void OnCapacity(size_t capacity) noexcept
     {
-        return data_.GetAddress() + size_;
+        size_t peak = peak_capacity_.load(std::memory_order_relaxed);
+        while (capacity > peak && !peak_capacity_.compare_exchange_weak(peak, capacity, std::memory_order_relaxed))
+        {
+        }
     }
-    const_iterator cend() const noexcept
+
+    static void OnReallocate(size_t moved, size_t copied, size_t bytes) noexcept
     {
-        return data_.GetAddress() + size_;
+        reallocations_.fetch_add(1, std::memory_order_relaxed);
+        moved_elements_.fetch_add(moved, std::memory_order_relaxed);
+        copied_elements_.fetch_add(copied, std::memory_order_relaxed);
+        relocated_bytes_.fetch_add(bytes, std::memory_order_relaxed);
     }
 
-    template <typename... Args>
-    iterator Emplace(const_iterator pos, Args &&...args)
+    static VectorStatsSnapshot Snapshot() noexcept
     {
-        const size_t offset = pos - begin();
+        VectorStatsSnapshot snapshot;
+        snapshot.allocations = allocations_.load(std::memory_order_relaxed);
+        snapshot.allocated_bytes = allocated_bytes_.load(std::memory_order_relaxed);
+        snapshot.reallocations = reallocations_.load(std::memory_order_relaxed);
+        snapshot.moved_elements = moved_elements_.load(std::memory_order_relaxed);
+        snapshot.copied_elements = copied_elements_.load(std::memory_order_relaxed);
+        snapshot.relocated_bytes = relocated_bytes_.load(std::memory_order_relaxed);
+        snapshot.peak_capacity = peak_capacity_.load(std::memory_order_relaxed);
+        return snapshot;
+    }
 
-        if (size_ == Capacity())
+    static void Reset() noexcept
+    {
+        allocations_ = 0;
+        allocated_bytes_ = 0;
+        reallocations_ = 0;
+        moved_elements_ = 0;
+        copied_elements_ = 0;
+        relocated_bytes_ = 0;
+        peak_capacity_ = 0;
+    }
+
+private:
+    static inline std::atomic<size_t> allocations_{0};
+    static inline std::atomic<size_t> allocated_bytes_{0};
+    static inline std::atomic<size_t> reallocations_{0};
+    static inline std::atomic<size_t> moved_elements_{0};
+    static inline std::atomic<size_t> copied_elements_{0};
+    static inline std::atomic<size_t> relocated_bytes_{0};
+    static inline std::atomic<size_t> peak_capacity_{0};
+};
+
+// Сырая память под capacity элементов типа T.
+// Память выделяется и освобождается аллокатором Alloc. Аллокатор хранится вместе с буфером
+// и перемещается/обменивается вместе с ним: буфер может освободить только тот аллокатор,
+// который его выделил (или равный ему). Правила propagate_on_container_* применяются в Vector.
+// О выделениях памяти сообщается политике статистики Stats
+template <typename T, typename Alloc = std::allocator<T>, typename Stats = NoStats>
+class RawMemory
+{
+    using AllocTraits = std::allocator_traits<Alloc>;
+    static_assert(std::is_same_v<typename AllocTraits::value_type, T>,
+                  "Alloc::value_type must be T");
+
+public:
+    using allocator_type = Alloc;
+
+    // Буфер можно расширить на месте без переноса элементов
+    static constexpr bool CAN_EXPAND = detail::HasTryExpand<Alloc>::value;
+    // Буфер можно увеличить с побайтовым сохранением содержимого (подходит только
+    // для тривиально перемещаемых T)
+    static constexpr bool CAN_REALLOCATE = detail::HasReallocate<Alloc>::value;
+
+    RawMemory() = default;
+
+    VECTOR_CONSTEXPR explicit RawMemory(const Alloc &alloc) noexcept
+        : alloc_(alloc)
+    {
+    }
+
+    VECTOR_CONSTEXPR explicit RawMemory(size_t capacity, const Alloc &alloc = Alloc())
+        : alloc_(alloc), buffer_(Allocate(capacity)), capacity_(capacity)
+    {
+    }
+
+    // Берет во владение буфер емкости capacity, выделенный аллокатором alloc (или равным ему)
+    VECTOR_CONSTEXPR RawMemory(T *buffer, size_t capacity, const Alloc &alloc) noexcept
+        : alloc_(alloc), buffer_(buffer), capacity_(capacity)
+    {
+    }
+
+    VECTOR_CONSTEXPR ~RawMemory()
+    {
+        Deallocate(buffer_);
+        capacity_ = 0;
+    }
+
+    RawMemory(const RawMemory &) = delete;
+    RawMemory &operator=(const RawMemory &rhs) = delete;
+    VECTOR_CONSTEXPR RawMemory(RawMemory &&other) noexcept
+        : alloc_(std::move(other.alloc_)),
+          buffer_(std::move(other.buffer_)),
+          capacity_(other.capacity_)
+    {
+        other.buffer_ = nullptr;
+        other.capacity_ = 0;
+    }
+    VECTOR_CONSTEXPR RawMemory &operator=(RawMemory &&rhs) noexcept
+    {
+        if (this != &rhs)
         {
-            // Увеличиваем емкость
-            const size_t new_capacity = std::max(size_t(1), Capacity() * 2);
-            RawMemory<T> new_data(new_capacity);
-            T *new_start = new_data.GetAddress();
-            T *new_finish = new_start;
-            // T *new_elem_pos = data_ + offset;
+            Deallocate(buffer_);
+            // Вместе с буфером забираем и аллокатор, которым он был выделен
+            alloc_ = std::move(rhs.alloc_);
+            buffer_ = std::move(rhs.buffer_);
+            capacity_ = std::move(rhs.capacity_);
+
+            rhs.buffer_ = nullptr;
+            rhs.capacity_ = 0;
+        }
+        return *this;
+    }
+
+    VECTOR_CONSTEXPR T *operator+(size_t offset) noexcept
+    {
+        // Разрешается получать адрес ячейки памяти, следующей за последним элементом массива
+        assert(offset <= capacity_);
+        return buffer_ + offset;
+    }
+
+    VECTOR_CONSTEXPR const T *operator+(size_t offset) const noexcept
+    {
+        return const_cast<RawMemory &>(*this) + offset;
+    }
+
+    VECTOR_CONSTEXPR const T &operator[](size_t index) const noexcept
+    {
+        return const_cast<RawMemory &>(*this)[index];
+    }
+
+    VECTOR_CONSTEXPR T &operator[](size_t index) noexcept
+    {
+        assert(index < capacity_);
+        return buffer_[index];
+    }
+
+    VECTOR_CONSTEXPR void Swap(RawMemory &other) noexcept
+    {
+        using std::swap;
+        swap(alloc_, other.alloc_);
+        std::swap(buffer_, other.buffer_);
+        std::swap(capacity_, other.capacity_);
+    }
+
+    VECTOR_CONSTEXPR const T *GetAddress() const noexcept
+    {
+        return buffer_;
+    }
+
+    VECTOR_CONSTEXPR T *GetAddress() noexcept
+    {
+        return buffer_;
+    }
+
+    VECTOR_CONSTEXPR size_t Capacity() const noexcept
+    {
+        return capacity_;
+    }
+
+    VECTOR_CONSTEXPR const Alloc &GetAllocator() const noexcept
+    {
+        return alloc_;
+    }
+
+    // Отказывается от владения буфером, не освобождая его
+    VECTOR_CONSTEXPR void Detach() noexcept
+    {
+        buffer_ = nullptr;
+        capacity_ = 0;
+    }
+
+    // Пытается увеличить емкость до new_capacity, не перемещая буфер.
+    // Возвращает false, если аллокатор этого не умеет или расширение не удалось
+    VECTOR_CONSTEXPR bool TryExpand(size_t new_capacity) noexcept
+    {
+        if constexpr (CAN_EXPAND)
+        {
+            if (buffer_ != nullptr && alloc_.try_expand(buffer_, capacity_, new_capacity))
+            {
+                Stats::OnAllocate((new_capacity - capacity_) * sizeof(T));
+                Stats::OnCapacity(new_capacity);
+                capacity_ = new_capacity;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Изменяет емкость буфера, побайтово сохраняя его содержимое. Буфер может переехать,
+    // поэтому вызывать можно только для тривиально перемещаемых T.
+    // Если аллокатор выбросит исключение, буфер останется прежним
+    void Reallocate(size_t new_capacity)
+    {
+        static_assert(CAN_REALLOCATE, "Alloc does not provide reallocate()");
+        static_assert(IsTriviallyRelocatableV<T>, "Reallocate requires trivially relocatable T");
+        buffer_ = alloc_.reallocate(buffer_, capacity_, new_capacity);
+        Stats::OnAllocate(new_capacity * sizeof(T));
+        Stats::OnCapacity(new_capacity);
+        capacity_ = new_capacity;
+    }
+
+private:
+    // Выделяет сырую память под n элементов и возвращает указатель на неё
+    VECTOR_CONSTEXPR T *Allocate(size_t n)
+    {
+        if (n == 0)
+        {
+            return nullptr;
+        }
+        T *buf = AllocTraits::allocate(alloc_, n);
+        Stats::OnAllocate(n * sizeof(T));
+        Stats::OnCapacity(n);
+        return buf;
+    }
+
+    // Освобождает сырую память, выделенную ранее по адресу buf при помощи Allocate
+    VECTOR_CONSTEXPR void Deallocate(T *buf) noexcept
+    {
+        if (buf != nullptr)
+        {
+            AllocTraits::deallocate(alloc_, buf, capacity_);
+        }
+    }
+
+    Alloc alloc_;
+    T *buffer_ = nullptr;
+    size_t capacity_ = 0;
+};
+
+// Тег конструирования элементов инициализацией по умолчанию: элементы тривиальных типов
+// остаются неинициализированными, что избавляет от лишнего прохода по памяти, когда буфер
+// сразу же будет заполнен (например, вызовом read())
+struct DefaultInitTag
+{
+    explicit DefaultInitTag() = default;
+};
+
+inline constexpr DefaultInitTag DEFAULT_INIT{};
+
+// Тег параллельного выполнения массовых операций: элементы создаются, копируются, переносятся
+// и уничтожаются частями в threads потоках (0 — по числу ядер). Небольшие векторы
+// обрабатываются в вызывающем потоке
+struct ParallelTag
+{
+    constexpr explicit ParallelTag(size_t threads = 0) noexcept
+        : threads(threads)
+    {
+    }
+
+    size_t threads;
+};
+
+inline constexpr ParallelTag PARALLEL{};
+
+namespace detail
+{
+    // Объем данных, на меньшие части которого работа не делится
+    inline constexpr size_t PARALLEL_MIN_BYTES = 1 << 20;
+
+    // Делит [0, count) на части и вызывает body(first, last) для каждой части в своем потоке.
+    // body при исключении должен сам уничтожить созданное им. Если хотя бы одна часть
+    // завершилась исключением, для всех успешных частей вызывается rollback(first, last),
+    // после чего первое исключение выбрасывается дальше. Если поток не удалось запустить,
+    // его часть выполняется в вызывающем потоке, поэтому при небросающем body ParallelFor
+    // тоже не выбрасывает исключений
+    template <typename Body, typename Rollback>
+    void ParallelFor(size_t count, size_t element_size, ParallelTag tag, Body body, Rollback rollback)
+    {
+        const size_t threads = tag.threads != 0 ? tag.threads : std::max(1u, std::thread::hardware_concurrency());
+        const size_t chunks = std::max(size_t(1), std::min(threads, count * element_size / PARALLEL_MIN_BYTES));
+        if (chunks == 1)
+        {
+            body(size_t(0), count);
+            return;
+        }
+
+        const auto chunk_begin = [count, chunks](size_t chunk)
+        {
+            return count / chunks * chunk + std::min(chunk, count % chunks);
+        };
+        std::unique_ptr<std::exception_ptr[]> errors(new (std::nothrow) std::exception_ptr[chunks]);
+        std::unique_ptr<std::thread[]> workers(new (std::nothrow) std::thread[chunks]);
+        if (!errors || !workers)
+        {
+            body(size_t(0), count);
+            return;
+        }
+        const auto run = [&](size_t chunk) noexcept
+        {
+            try
+            {
+                body(chunk_begin(chunk), chunk_begin(chunk + 1));
+            }
+            catch (...)
+            {
+                errors[chunk] = std::current_exception();
+            }
+        };
+
+        // Первую часть выполняет вызывающий поток
+        for (size_t chunk = 1; chunk < chunks; ++chunk)
+        {
+            try
+            {
+                workers[chunk] = std::thread(run, chunk);
+            }
+            catch (...)
+            {
+                run(chunk);
+            }
+        }
+        run(0);
+        for (size_t chunk = 1; chunk < chunks; ++chunk)
+        {
+            if (workers[chunk].joinable())
+            {
+                workers[chunk].join();
+            }
+        }
+
+        std::exception_ptr first_error;
+        for (size_t chunk = 0; chunk < chunks; ++chunk)
+        {
+            if (errors[chunk] && !first_error)
+            {
+                first_error = errors[chunk];
+            }
+        }
+        if (first_error)
+        {
+            for (size_t chunk = 0; chunk < chunks; ++chunk)
+            {
+                if (!errors[chunk])
+                {
+                    rollback(chunk_begin(chunk), chunk_begin(chunk + 1));
+                }
+            }
+            std::rethrow_exception(first_error);
+        }
+    }
+
+    // Вызывает body(first, last) для частей [0, count), body не выбрасывает исключений
+    template <typename Body>
+    void ParallelFor(size_t count, size_t element_size, ParallelTag tag, Body body) noexcept
+    {
+        ParallelFor(count, element_size, tag, body, [](size_t, size_t) noexcept {});
+    }
+} // namespace detail
+
+// Непрерывный диапазон элементов, не владеющий ими
+template <typename T>
+class Span
+{
+public:
+    Span(T *data, size_t size) noexcept
+        : data_(data), size_(size)
+    {
+    }
+
+    T *Data() const noexcept
+    {
+        return data_;
+    }
+
+    size_t Size() const noexcept
+    {
+        return size_;
+    }
+
+    T &operator[](size_t index) const noexcept
+    {
+        assert(index < size_);
+        return data_[index];
+    }
+
+    T *begin() const noexcept
+    {
+        return data_;
+    }
+
+    T *end() const noexcept
+    {
+        return data_ + size_;
+    }
+
+private:
+    T *data_;
+    size_t size_;
+};
+
+// Буфер, отданный вектором (см. Vector::Detach). Элементы [data, data + size) созданы,
+// после их уничтожения память освобождается вызовом allocator.deallocate(data, capacity)
+template <typename T, typename Alloc>
+struct DetachedBuffer
+{
+    T *data = nullptr;
+    size_t size = 0;
+    size_t capacity = 0;
+    Alloc allocator;
+};
+
+// Политики проверки доступа к элементам вектора:
+//     CHECK_BOUNDS     — индексы и позиции проверяются в любой сборке, а не только assert;
+//     TRACK_ITERATORS  — итератор запоминает поколение буфера и при разыменовании проверяет,
+//                        что буфер не заменялся (реаллокация в Reserve, Emplace, Insert,
+//                        ShrinkToFit, присваивание, обмен) и что элемент еще существует;
+//     OnViolation(msg) — вызывается при нарушении проверки и не должен возвращать управление.
+// Собственная политика может, например, записать сообщение в журнал перед завершением.
+// At() проверяет индекс и выбрасывает std::out_of_range независимо от политики
+
+// Проверки только через assert. Итераторы — указатели
+struct AssertChecks
+{
+    static constexpr bool CHECK_BOUNDS = false;
+    static constexpr bool TRACK_ITERATORS = false;
+};
+
+// Проверка индексов в любой сборке: одно сравнение с маловероятным переходом на __builtin_trap.
+// Подходит для рабочих сборок, итераторы остаются указателями
+struct TrapChecks
+{
+    static constexpr bool CHECK_BOUNDS = true;
+    static constexpr bool TRACK_ITERATORS = false;
+
+    [[noreturn]] static void OnViolation(const char * /*message*/) noexcept
+    {
+#if defined(__GNUC__)
+        __builtin_trap();
+#else
+        std::abort();
+#endif
+    }
+};
+
+// Отладочные проверки индексов и действительности итераторов. Сообщение о нарушении выводится
+// в stderr перед std::abort. Итератор хранит указатель на вектор и поколение буфера, поэтому
+// втрое больше указателя
+struct DebugChecks
+{
+    static constexpr bool CHECK_BOUNDS = true;
+    static constexpr bool TRACK_ITERATORS = true;
+
+    [[noreturn]] static void OnViolation(const char *message) noexcept
+    {
+        std::fprintf(stderr, "Vector check failed: %s\n", message);
+        std::abort();
+    }
+};
+
+namespace detail
+{
+    template <typename Checks>
+    constexpr bool NothrowChecks() noexcept
+    {
+        if constexpr (Checks::CHECK_BOUNDS)
+        {
+            return noexcept(Checks::OnViolation(""));
+        }
+        else
+        {
+            return true;
+        }
+    }
+
+    // Поколение буфера вектора, увеличивается при каждой замене буфера.
+    // Без отслеживания итераторов база пуста и не увеличивает размер вектора
+    template <bool TRACK>
+    struct BufferGeneration
+    {
+        static constexpr size_t Generation() noexcept
+        {
+            return 0;
+        }
+
+        constexpr void NextGeneration() noexcept
+        {
+        }
+    };
+
+    template <>
+    struct BufferGeneration<true>
+    {
+        constexpr size_t Generation() const noexcept
+        {
+            return generation_;
+        }
+
+        constexpr void NextGeneration() noexcept
+        {
+            ++generation_;
+        }
+
+        size_t generation_ = 0;
+    };
+
+    // Итератор вектора, отслеживающего итераторы. Запоминает поколение буфера, в котором создан;
+    // разыменование и разность итераторов проверяются вектором Owner
+    template <typename Owner, typename T>
+    class CheckedIterator
+    {
+    public:
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type = std::remove_const_t<T>;
+        using difference_type = std::ptrdiff_t;
+        using pointer = T *;
+        using reference = T &;
+
+        CheckedIterator() = default;
+
+        constexpr CheckedIterator(T *ptr, const Owner *owner, size_t generation) noexcept
+            : ptr_(ptr), owner_(owner), generation_(generation)
+        {
+        }
+
+        // Итератор преобразуется в константный
+        template <typename U, typename = std::enable_if_t<std::is_same_v<const U, T> && !std::is_same_v<U, T>>>
+        constexpr CheckedIterator(const CheckedIterator<Owner, U> &other) noexcept
+            : ptr_(other.ptr_), owner_(other.owner_), generation_(other.generation_)
+        {
+        }
+
+        constexpr reference operator*() const
+        {
+            assert(owner_ != nullptr);
+            owner_->CheckIterator(ptr_, generation_, true);
+            return *ptr_;
+        }
+
+        constexpr pointer operator->() const
+        {
+            return &**this;
+        }
+
+        constexpr reference operator[](difference_type n) const
+        {
+            return *(*this + n);
+        }
+
+        constexpr CheckedIterator &operator++() noexcept
+        {
+            ++ptr_;
+            return *this;
+        }
+
+        constexpr CheckedIterator operator++(int) noexcept
+        {
+            CheckedIterator copy = *this;
+            ++ptr_;
+            return copy;
+        }
+
+        constexpr CheckedIterator &operator--() noexcept
+        {
+            --ptr_;
+            return *this;
+        }
+
+        constexpr CheckedIterator operator--(int) noexcept
+        {
+            CheckedIterator copy = *this;
+            --ptr_;
+            return copy;
+        }
+
+        constexpr CheckedIterator &operator+=(difference_type n) noexcept
+        {
+            ptr_ += n;
+            return *this;
+        }
+
+        constexpr CheckedIterator &operator-=(difference_type n) noexcept
+        {
+            ptr_ -= n;
+            return *this;
+        }
+
+        friend constexpr CheckedIterator operator+(CheckedIterator it, difference_type n) noexcept
+        {
+            return it += n;
+        }
+
+        friend constexpr CheckedIterator operator+(difference_type n, CheckedIterator it) noexcept
+        {
+            return it += n;
+        }
+
+        friend constexpr CheckedIterator operator-(CheckedIterator it, difference_type n) noexcept
+        {
+            return it -= n;
+        }
+
+        // Оба итератора должны относиться к текущему буферу одного вектора
+        friend constexpr difference_type operator-(const CheckedIterator &lhs, const CheckedIterator &rhs)
+        {
+            return lhs.Distance(rhs);
+        }
+
+        friend constexpr bool operator==(const CheckedIterator &lhs, const CheckedIterator &rhs) noexcept
+        {
+            return lhs.ptr_ == rhs.ptr_;
+        }
+
+        friend constexpr bool operator!=(const CheckedIterator &lhs, const CheckedIterator &rhs) noexcept
+        {
+            return lhs.ptr_ != rhs.ptr_;
+        }
+
+        friend constexpr bool operator<(const CheckedIterator &lhs, const CheckedIterator &rhs) noexcept
+        {
+            return lhs.ptr_ < rhs.ptr_;
+        }
+
+        friend constexpr bool operator>(const CheckedIterator &lhs, const CheckedIterator &rhs) noexcept
+        {
+            return lhs.ptr_ > rhs.ptr_;
+        }
+
+        friend constexpr bool operator<=(const CheckedIterator &lhs, const CheckedIterator &rhs) noexcept
+        {
+            return lhs.ptr_ <= rhs.ptr_;
+        }
+
+        friend constexpr bool operator>=(const CheckedIterator &lhs, const CheckedIterator &rhs) noexcept
+        {
+            return lhs.ptr_ >= rhs.ptr_;
+        }
+
+    private:
+        template <typename, typename>
+        friend class CheckedIterator;
+
+        constexpr difference_type Distance(const CheckedIterator &other) const
+        {
+            assert(owner_ != nullptr);
+            owner_->CheckIterators(ptr_, generation_, other.owner_, other.generation_);
+            return ptr_ - other.ptr_;
+        }
+
+        T *ptr_ = nullptr;
+        const Owner *owner_ = nullptr;
+        size_t generation_ = 0;
+    };
+} // namespace detail
+
+template <typename T, typename Alloc = std::allocator<T>, typename Growth = DoublingGrowth,
+          typename Stats = NoStats, typename Checks = AssertChecks>
+class Vector : private detail::BufferGeneration<Checks::TRACK_ITERATORS>
+{
+    using AllocTraits = std::allocator_traits<Alloc>;
+    using Memory = RawMemory<T, Alloc, Stats>;
+
+    template <typename, typename>
+    friend class detail::CheckedIterator;
+
+    static constexpr bool NOTHROW_CHECKS = detail::NothrowChecks<Checks>();
+
+public:
+    using allocator_type = Alloc;
+
+    Vector() = default;
+
+    VECTOR_CONSTEXPR explicit Vector(const Alloc &alloc) noexcept
+        : data_(alloc)
+    {
+    }
+
+    VECTOR_CONSTEXPR explicit Vector(size_t size, const Alloc &alloc = Alloc())
+        : data_(size, alloc), size_(size) //
+    {
+        detail::UninitializedValueConstructN(data_.GetAddress(), size);
+    }
+    // Создает size элементов инициализацией по умолчанию, см. DefaultInitTag
+    Vector(size_t size, DefaultInitTag, const Alloc &alloc = Alloc())
+        : data_(size, alloc), size_(size) //
+    {
+        std::uninitialized_default_construct_n(data_.GetAddress(), size);
+    }
+    // Как Vector(size), но элементы создаются параллельно
+    Vector(size_t size, ParallelTag tag, const Alloc &alloc = Alloc())
+        : data_(size, alloc), size_(size) //
+    {
+        T *const data = data_.GetAddress();
+        detail::ParallelFor(
+            size, sizeof(T), tag, [data](size_t first, size_t last)
+            { std::uninitialized_value_construct(data + first, data + last); },
+            [data](size_t first, size_t last) noexcept
+            { std::destroy(data + first, data + last); });
+    }
+    VECTOR_CONSTEXPR Vector(const Vector &other)
+        : Vector(other, AllocTraits::select_on_container_copy_construction(other.GetAllocator())) //
+    {
+    }
+    // Копирует элементы other параллельно. Если конструктор копирования выбросит исключение,
+    // уже созданные копии уничтожаются
+    Vector(const Vector &other, ParallelTag tag)
+        : data_(other.size_, AllocTraits::select_on_container_copy_construction(other.GetAllocator())),
+          size_(other.size_) //
+    {
+        const T *const from = other.data_.GetAddress();
+        T *const to = data_.GetAddress();
+        detail::ParallelFor(
+            size_, sizeof(T), tag, [from, to](size_t first, size_t last)
+            { std::uninitialized_copy(from + first, from + last, to + first); },
+            [to](size_t first, size_t last) noexcept
+            { std::destroy(to + first, to + last); });
+    }
+    VECTOR_CONSTEXPR Vector(const Vector &other, const Alloc &alloc)
+        : data_(other.size_, alloc), size_(other.size_) //
+    {
+        detail::UninitializedCopyN(other.data_.GetAddress(), other.size_, data_.GetAddress());
+    }
+    VECTOR_CONSTEXPR Vector(Vector &&other) noexcept
+        : data_(std::move(other.data_)), size_(other.size_)
+    {
+        other.size_ = 0;
+    }
+
+    // Создает вектор из буфера емкости capacity без копирования элементов. Буфер должен быть
+    // выделен аллокатором, равным alloc, а первые size элементов — уже созданы
+    static Vector Adopt(T *data, size_t size, size_t capacity, const Alloc &alloc = Alloc()) noexcept
+    {
+        return Vector(Memory(data, capacity, alloc), size);
+    }
+
+    // Создает вектор из внешнего буфера, который будет освобожден вызовом deleter(data).
+    // Доступно для аллокаторов, которые можно создать из (data, deleter), например
+    // ExternalBufferAllocator
+    template <typename Deleter, typename = std::enable_if_t<!std::is_same_v<std::decay_t<Deleter>, Alloc> &&
+                                                            std::is_constructible_v<Alloc, T *, Deleter>>>
+    static Vector Adopt(T *data, size_t size, size_t capacity, Deleter &&deleter)
+    {
+        return Adopt(data, size, capacity, Alloc(data, std::forward<Deleter>(deleter)));
+    }
+
+    // Отдает буфер вместе с элементами без копирования, вектор становится пустым
+    DetachedBuffer<T, Alloc> Detach() noexcept
+    {
+        DetachedBuffer<T, Alloc> buffer{data_.GetAddress(), size_, data_.Capacity(), GetAllocator()};
+        data_.Detach();
+        size_ = 0;
+        InvalidateIterators();
+        return buffer;
+    }
+
+    VECTOR_CONSTEXPR ~Vector()
+    {
+        std::destroy_n(data_.GetAddress(), size_);
+    }
+    VECTOR_CONSTEXPR size_t Size() const noexcept
+    {
+        return size_;
+    }
+
+    VECTOR_CONSTEXPR const Alloc &GetAllocator() const noexcept
+    {
+        return data_.GetAllocator();
+    }
+
+    VECTOR_CONSTEXPR Vector &operator=(const Vector &rhs)
+    {
+        Assign(rhs, true);
+        return *this;
+    }
+    VECTOR_CONSTEXPR Vector &operator=(Vector &&rhs) noexcept(AllocTraits::propagate_on_container_move_assignment::value ||
+                                             AllocTraits::is_always_equal::value)
+    {
+        if constexpr (!AllocTraits::propagate_on_container_move_assignment::value &&
+                      !AllocTraits::is_always_equal::value)
+        {
+            if (GetAllocator() != rhs.GetAllocator())
+            {
+                // Чужой буфер забрать нельзя: перемещаем элементы поштучно в память нашего аллокатора
+                Vector tmp(GetAllocator());
+                tmp.Reserve(rhs.size_);
+                std::uninitialized_move_n(rhs.data_.GetAddress(), rhs.size_, tmp.data_.GetAddress());
+                tmp.size_ = rhs.size_;
+                SwapBuffers(tmp);
+                return *this;
+            }
+        }
+        SwapBuffers(rhs);
+
+        return *this;
+    }
+
+    // Если аллокатор не распространяется при обмене (propagate_on_container_swap == false),
+    // аллокаторы векторов должны быть равны
+    VECTOR_CONSTEXPR void Swap(Vector &other) noexcept
+    {
+        if constexpr (!AllocTraits::propagate_on_container_swap::value &&
+                      !AllocTraits::is_always_equal::value)
+        {
+            assert(GetAllocator() == other.GetAllocator());
+        }
+        SwapBuffers(other);
+    }
+
+    VECTOR_CONSTEXPR size_t Capacity() const noexcept
+    {
+        return data_.Capacity();
+    }
+    VECTOR_CONSTEXPR void Reserve(size_t new_capacity)
+    {
+        if (new_capacity <= data_.Capacity())
+        {
+            return;
+        }
+        if (data_.TryExpand(new_capacity))
+        {
+            return;
+        }
+        ChangeCapacity(new_capacity);
+    }
+
+    // Как Reserve, но элементы переносятся в новый буфер параллельно. Если при копировании
+    // элемента выбросится исключение, вектор остается неизменным
+    void Reserve(size_t new_capacity, ParallelTag tag)
+    {
+        if (new_capacity <= data_.Capacity() || data_.TryExpand(new_capacity))
+        {
+            return;
+        }
+        if constexpr (IsTriviallyRelocatableV<T> && Memory::CAN_REALLOCATE)
+        {
+            // Буфер переезжает целиком, переносить элементы по частям не нужно
+            ChangeCapacity(new_capacity);
+            return;
+        }
+        Memory new_data(new_capacity, GetAllocator());
+        T *const from = data_.GetAddress();
+        T *const to = new_data.GetAddress();
+        if constexpr (IsTriviallyRelocatableV<T>)
+        {
+            detail::ParallelFor(size_, sizeof(T), tag, [from, to](size_t first, size_t last) noexcept
+                                { detail::RelocateN(from + first, last - first, to + first); });
+        }
+        else
+        {
+            detail::ParallelFor(
+                size_, sizeof(T), tag, [from, to](size_t first, size_t last)
+                { detail::UninitializedMoveOrCopyN(from + first, last - first, to + first); },
+                [to](size_t first, size_t last) noexcept
+                { std::destroy(to + first, to + last); });
+            Destroy(from, size_, tag);
+        }
+        RecordRelocation(size_);
+        data_.Swap(new_data);
+        InvalidateIterators();
+    }
+
+    // Уменьшает емкость до размера вектора, перенося элементы так же, как Reserve.
+    // Если выделение нового буфера или копирование элемента выбросит исключение,
+    // вектор остается неизменным
+    void ShrinkToFit()
+    {
+        if (size_ == data_.Capacity())
+        {
+            return;
+        }
+        if (size_ == 0)
+        {
+            Release();
+            return;
+        }
+        ChangeCapacity(size_);
+    }
+
+    // Удаляет все элементы, сохраняя емкость
+    VECTOR_CONSTEXPR void Clear() noexcept
+    {
+        std::destroy_n(data_.GetAddress(), size_);
+        size_ = 0;
+    }
+
+    // Удаляет все элементы и освобождает память
+    VECTOR_CONSTEXPR void Release() noexcept
+    {
+        Clear();
+        Memory empty(GetAllocator());
+        data_.Swap(empty);
+        InvalidateIterators();
+    }
+
+    // Как Clear, но элементы уничтожаются параллельно
+    void Clear(ParallelTag tag) noexcept
+    {
+        Destroy(data_.GetAddress(), size_, tag);
+        size_ = 0;
+    }
+
+    // Как Release, но элементы уничтожаются параллельно
+    void Release(ParallelTag tag) noexcept
+    {
+        Clear(tag);
+        Release();
+    }
+
+    VECTOR_CONSTEXPR void Resize(size_t new_size)
+    {
+        if (size_ >= new_size)
+        {
+            std::destroy_n(data_.GetAddress() + new_size, size_ - new_size);
+            size_ = new_size;
+        }
+        else
+        {
+            Reserve(new_size);
+            detail::UninitializedValueConstructN(data_.GetAddress() + size_, new_size - size_);
+            size_ = new_size;
+        }
+    }
+
+    // Как Resize, но новые элементы создаются инициализацией по умолчанию, см. DefaultInitTag
+    void ResizeUninitialized(size_t new_size)
+    {
+        if (size_ >= new_size)
+        {
+            std::destroy_n(data_.GetAddress() + new_size, size_ - new_size);
+        }
+        else
+        {
+            Reserve(new_size);
+            std::uninitialized_default_construct_n(data_.GetAddress() + size_, new_size - size_);
+        }
+        size_ = new_size;
+    }
+    VECTOR_CONSTEXPR void PushBack(const T &value)
+    {
+        EmplaceBack(value);
+    }
+    VECTOR_CONSTEXPR void PushBack(T &&value)
+    {
+        EmplaceBack(std::move(value));
+    }
+    VECTOR_CONSTEXPR void PopBack() noexcept(NOTHROW_CHECKS)
+    {
+        Check(size_ > 0, "Vector::PopBack on empty vector");
+        std::destroy_at(data_.GetAddress() + size_ - 1);
+        --size_;
+    }
+    template <typename... Args>
+    VECTOR_CONSTEXPR T &EmplaceBack(Args &&...args)
+    {
+        if (detail::IsConstantEvaluated())
+        {
+            return ConstantEmplaceBack(std::forward<Args>(args)...);
+        }
+        return *Emplace(end(), std::forward<Args>(args)...);
+    }
+    VECTOR_CONSTEXPR const T &operator[](size_t index) const noexcept(NOTHROW_CHECKS)
+    {
+        return const_cast<Vector &>(*this)[index];
+    }
+
+    VECTOR_CONSTEXPR T &operator[](size_t index) noexcept(NOTHROW_CHECKS)
+    {
+        Check(index < size_, "Vector index out of range");
+        return *(data_.GetAddress() + index);
+    }
+
+    // Доступ с проверкой индекса при любой политике Checks.
+    // Выбрасывает std::out_of_range, если index >= Size()
+    VECTOR_CONSTEXPR const T &At(size_t index) const
+    {
+        return const_cast<Vector &>(*this).At(index);
+    }
+
+    VECTOR_CONSTEXPR T &At(size_t index)
+    {
+        if (VECTOR_UNLIKELY(index >= size_))
+        {
+            throw std::out_of_range("Vector::At index out of range");
+        }
+        return *(data_.GetAddress() + index);
+    }
+
+    // Указатель на первый элемент буфера при любой политике Checks
+    VECTOR_CONSTEXPR T *Data() noexcept
+    {
+        return data_.GetAddress();
+    }
+    VECTOR_CONSTEXPR const T *Data() const noexcept
+    {
+        return data_.GetAddress();
+    }
+
+    // С политикой, отслеживающей итераторы, итераторы проверяются при разыменовании,
+    // иначе это указатели
+    using iterator = std::conditional_t<Checks::TRACK_ITERATORS, detail::CheckedIterator<Vector, T>, T *>;
+    using const_iterator =
+        std::conditional_t<Checks::TRACK_ITERATORS, detail::CheckedIterator<Vector, const T>, const T *>;
 
-            try
-            {
-                // Создаем новый элемент в нужной позиции
-                new (new_start + offset) T(std::forward<Args>(args)...);
+    VECTOR_CONSTEXPR iterator begin() noexcept
+    {
+        return MakeIterator<iterator>(data_.GetAddress());
+    }
+    VECTOR_CONSTEXPR const_iterator begin() const noexcept
+    {
+        return MakeIterator<const_iterator>(data_.GetAddress());
+    }
+    VECTOR_CONSTEXPR const_iterator cbegin() const noexcept
+    {
+        return begin();
+    }
+    VECTOR_CONSTEXPR iterator end() noexcept
+    {
+        return MakeIterator<iterator>(data_.GetAddress() + size_);
+    }
+    VECTOR_CONSTEXPR const_iterator end() const noexcept
+    {
+        return MakeIterator<const_iterator>(data_.GetAddress() + size_);
+    }
+    VECTOR_CONSTEXPR const_iterator cend() const noexcept
+    {
+        return end();
+    }
 
-                new_finish = nullptr;
+    template <typename... Args>
+    iterator Emplace(const_iterator pos, Args &&...args)
+    {
+        const size_t offset = Offset(pos);
 
-                // Переносим/копируем элементы до точки вставки
-                if constexpr (std::is_nothrow_move_constructible_v<T> || !std::is_copy_constructible_v<T>)
+        // Расширение на месте не перемещает элементы, после него достаточно вставки без реаллокации
+        if (size_ == Capacity() && !data_.TryExpand(NextCapacity()))
+        {
+            // Увеличиваем емкость
+            const size_t new_capacity = NextCapacity();
+            if constexpr (IsTriviallyRelocatableV<T> && Memory::CAN_REALLOCATE)
+            {
+                // Аргументы могут ссылаться на элементы вектора, которые переедут вместе с буфером,
+                // поэтому новый элемент сначала создаем во временном хранилище
+                alignas(T) unsigned char storage[sizeof(T)];
+                T *elem = new (storage) T(std::forward<Args>(args)...);
+                try
                 {
-                    new_finish = std::uninitialized_move_n(begin(), offset, new_start).second;
+                    data_.Reallocate(new_capacity);
                 }
-                else
+                catch (...)
                 {
-                    new_finish = std::uninitialized_copy_n(begin(), offset, new_start);
+                    std::destroy_at(elem);
+                    throw;
                 }
+                RecordRelocation(size_);
+                InvalidateIterators();
+                T *elem_pos = data_.GetAddress() + offset;
+                std::memmove(static_cast<void *>(elem_pos + 1), static_cast<const void *>(elem_pos),
+                             (size_ - offset) * sizeof(T));
+                std::memcpy(static_cast<void *>(elem_pos), static_cast<const void *>(elem), sizeof(T));
+                ++size_;
+                return begin() + offset;
+            }
+
+            Memory new_data(new_capacity, GetAllocator());
+            T *new_start = new_data.GetAddress();
 
-                // Пропускаем новый элемент
-                ++new_finish;
+            if constexpr (IsTriviallyRelocatableV<T>)
+            {
+                // Создаем новый элемент в нужной позиции. Если конструктор выбросит исключение,
+                // new_data освободит память, а старые элементы останутся нетронутыми
+                new (new_start + offset) T(std::forward<Args>(args)...);
 
-                // Переносим/копируем элементы после точки вставки
-                if constexpr (std::is_nothrow_move_constructible_v<T> || !std::is_copy_constructible_v<T>)
-                {
-                    new_finish = std::uninitialized_move_n(begin() + offset, size_ - offset, new_finish).second;
-                }
-                else
-                {
-                    new_finish = std::uninitialized_copy_n(begin() + offset, size_ - offset, new_finish);
-                }
+                // Переносим элементы до и после точки вставки побайтово
+                detail::RelocateN(data_.GetAddress(), offset, new_start);
+                detail::RelocateN(data_ + offset, size_ - offset, new_start + offset + 1);
             }
-            catch (...)
+            else
             {
-                if (!new_finish)
+                T *new_finish = new_start;
+                // T *new_elem_pos = data_ + offset;
+
+                try
                 {
-                    std::destroy_at(new_data.GetAddress() + offset);
+                    // Создаем новый элемент в нужной позиции
+                    new (new_start + offset) T(std::forward<Args>(args)...);
+
+                    new_finish = nullptr;
+
+                    // Переносим/копируем элементы до точки вставки
+                    if constexpr (std::is_nothrow_move_constructible_v<T> || !std::is_copy_constructible_v<T>)
+                    {
+                        new_finish = std::uninitialized_move_n(data_.GetAddress(), offset, new_start).second;
+                    }
+                    else
+                    {
+                        new_finish = std::uninitialized_copy_n(data_.GetAddress(), offset, new_start);
+                    }
+
+                    // Пропускаем новый элемент
+                    ++new_finish;
+
+                    // Переносим/копируем элементы после точки вставки
+                    if constexpr (std::is_nothrow_move_constructible_v<T> || !std::is_copy_constructible_v<T>)
+                    {
+                        new_finish = std::uninitialized_move_n(data_ + offset, size_ - offset, new_finish).second;
+                    }
+                    else
+                    {
+                        new_finish = std::uninitialized_copy_n(data_ + offset, size_ - offset, new_finish);
+                    }
                 }
-                else
+                catch (...)
                 {
-                    std::destroy(new_data.GetAddress(), new_finish);
+                    if (!new_finish)
+                    {
+                        std::destroy_at(new_data.GetAddress() + offset);
+                    }
+                    else
+                    {
+                        std::destroy(new_data.GetAddress(), new_finish);
+                    }
+                    throw;
                 }
-                throw;
+
+                // Удаляем старые элементы и меняем буферы
+                std::destroy_n(data_.GetAddress(), size_);
             }
 
-            // Удаляем старые элементы и меняем буферы
-            std::destroy_n(begin(), size_);
+            RecordRelocation(size_);
             data_.Swap(new_data);
+            InvalidateIterators();
             ++size_;
         }
         else
         {
             T *new_elem_pos = data_ + offset;
-            if (offset == size_)
+            // Сравнение offset >= size_ вместо == позволяет компилятору доказать, что сдвигаемый
+            // диапазон ниже не пуст, и не предупреждать о memmove отрицательной длины
+            if (offset >= size_)
             {
                 new (new_elem_pos) T(std::forward<Args>(args)...);
                 ++size_;
@@ -360,9 +1745,10 @@ public:
             else
             {
                 T tmp_copy(std::forward<Args>(args)...);
-                new (data_ + size_) T(std::move(data_[size_ - 1]));
+                const size_t tail = size_ - offset - 1;
+                new (new_elem_pos + tail + 1) T(std::move(new_elem_pos[tail]));
                 ++size_;
-                std::move_backward(new_elem_pos, data_ + size_ - 2, data_ + size_ - 1);
+                std::move_backward(new_elem_pos, new_elem_pos + tail, new_elem_pos + tail + 1);
                 *new_elem_pos = std::move(tmp_copy);
             }
         }
@@ -373,14 +1759,89 @@ public:
 
     iterator Erase(const_iterator pos) /*noexcept(std::is_nothrow_move_assignable_v<T>)*/
     {
-
-        assert(pos >= begin() && pos < end());
-        const size_t offset = pos - begin();
+        const size_t offset = Offset(pos);
+        Check(offset < size_, "Vector::Erase position out of range");
         std::move(data_.GetAddress() + offset + 1, data_.GetAddress() + size_, data_.GetAddress() + offset);
 
         std::destroy_at(data_.GetAddress() + size_ - 1);
         --size_;
-        return data_.GetAddress() + offset;
+        return begin() + offset;
+    }
+    // Удаляет элементы диапазона [first, last), сдвигая хвост один раз.
+    // Тривиально перемещаемые элементы сдвигаются побайтово, остальные — перемещающим присваиванием
+    iterator Erase(const_iterator first, const_iterator last) noexcept((IsTriviallyRelocatableV<T> ||
+                                                                        std::is_nothrow_move_assignable_v<T>) &&
+                                                                       NOTHROW_CHECKS)
+    {
+        const size_t offset = Offset(first);
+        const size_t last_offset = Offset(last);
+        Check(offset <= last_offset, "Vector::Erase range is reversed");
+        const size_t count = last_offset - offset;
+        if (count == 0)
+        {
+            return begin() + offset;
+        }
+        T *const erase_pos = data_.GetAddress() + offset;
+        if constexpr (IsTriviallyRelocatableV<T>)
+        {
+            std::destroy_n(erase_pos, count);
+            std::memmove(static_cast<void *>(erase_pos), static_cast<const void *>(erase_pos + count),
+                         (size_ - offset - count) * sizeof(T));
+        }
+        else
+        {
+            T *const old_end = data_.GetAddress() + size_;
+            std::move(erase_pos + count, old_end, erase_pos);
+            std::destroy_n(old_end - count, count);
+        }
+        size_ -= count;
+        return begin() + offset;
+    }
+
+    // Удаляет элемент pos за O(1): на его место переносится последний элемент, порядок
+    // элементов не сохраняется. Возвращает итератор на элемент, занявший место удаленного,
+    // или end(), если удален последний. Тривиально перемещаемые элементы переносятся побайтово
+    // и операция не выбрасывает исключений. Для остальных используется перемещающее присваивание;
+    // если оно выбросит исключение, размер вектора не изменится (базовая гарантия)
+    iterator SwapErase(const_iterator pos) noexcept((IsTriviallyRelocatableV<T> ||
+                                                     std::is_nothrow_move_assignable_v<T>) &&
+                                                    NOTHROW_CHECKS)
+    {
+        const size_t offset = Offset(pos);
+        Check(offset < size_, "Vector::SwapErase position out of range");
+        T *const erase_pos = data_.GetAddress() + offset;
+        T *const last = data_.GetAddress() + size_ - 1;
+        if constexpr (IsTriviallyRelocatableV<T>)
+        {
+            std::destroy_at(erase_pos);
+            if (erase_pos != last)
+            {
+                std::memcpy(static_cast<void *>(erase_pos), static_cast<const void *>(last), sizeof(T));
+            }
+        }
+        else
+        {
+            if (erase_pos != last)
+            {
+                *erase_pos = std::move(*last);
+            }
+            std::destroy_at(last);
+        }
+        --size_;
+        return begin() + offset;
+    }
+
+    // Удаляет все элементы, удовлетворяющие предикату, за один проход с сохранением порядка
+    // оставшихся элементов. Возвращает количество удаленных элементов
+    template <typename Predicate>
+    size_t EraseIf(Predicate pred)
+    {
+        T *const old_end = data_.GetAddress() + size_;
+        T *const new_end = std::remove_if(data_.GetAddress(), old_end, pred);
+        const size_t removed = old_end - new_end;
+        std::destroy(new_end, old_end);
+        size_ -= removed;
+        return removed;
     }
     iterator Insert(const_iterator pos, const T &value)
     {
@@ -391,8 +1852,434 @@ public:
         return Emplace(pos, std::move(value));
     }
 
+    // Вставляет элементы диапазона [first, last) перед pos. Итераторы не должны указывать
+    // на элементы самого вектора. Емкость увеличивается не более одного раза, хвост сдвигается
+    // один раз. Если потребовалась реаллокация или T тривиально перемещаем, при исключении
+    // вектор остается неизменным, иначе предоставляется базовая гарантия
+    template <typename InputIt, typename = detail::RequireInputIterator<InputIt>>
+    iterator Insert(const_iterator pos, InputIt first, InputIt last)
+    {
+        if constexpr (detail::IS_FORWARD_ITERATOR<InputIt>)
+        {
+            return InsertRange(pos, first, static_cast<size_t>(std::distance(first, last)));
+        }
+        else
+        {
+            // Длину диапазона заранее не узнать, поэтому сначала собираем его во временный вектор
+            Vector tmp(GetAllocator());
+            for (; first != last; ++first)
+            {
+                tmp.EmplaceBack(*first);
+            }
+            return InsertRange(pos, std::make_move_iterator(tmp.begin()), tmp.size_);
+        }
+    }
+
+    // Вставляет count копий value перед pos. value может ссылаться на элемент вектора
+    iterator Insert(const_iterator pos, size_t count, const T &value)
+    {
+        const std::less<const T *> less;
+        if (!less(&value, data_.GetAddress()) && less(&value, data_.GetAddress() + size_))
+        {
+            // value находится среди сдвигаемых элементов, поэтому вставляем его копию
+            const T value_copy(value);
+            return InsertRange(pos, detail::RepeatIterator<T>(value_copy), count);
+        }
+        return InsertRange(pos, detail::RepeatIterator<T>(value), count);
+    }
+
+    // Добавляет элементы range в конец вектора
+    template <typename Range>
+    void Append(const Range &range)
+    {
+        Insert(end(), std::begin(range), std::end(range));
+    }
+
+    // Заменяет содержимое вектора элементами диапазона [first, last), переиспользуя
+    // имеющиеся элементы и емкость. Итераторы не должны указывать на элементы самого вектора
+    template <typename InputIt, typename = detail::RequireInputIterator<InputIt>>
+    void AssignRange(InputIt first, InputIt last)
+    {
+        if constexpr (detail::IS_FORWARD_ITERATOR<InputIt>)
+        {
+            const size_t count = static_cast<size_t>(std::distance(first, last));
+            if (count > Capacity())
+            {
+                Vector tmp(GetAllocator());
+                tmp.Reserve(count);
+                std::uninitialized_copy_n(first, count, tmp.data_.GetAddress());
+                tmp.size_ = count;
+                SwapBuffers(tmp);
+                return;
+            }
+            const size_t min_size = std::min(size_, count);
+            for (size_t i = 0; i < min_size; ++i, ++first)
+            {
+                data_[i] = *first;
+            }
+            if (count > size_)
+            {
+                std::uninitialized_copy_n(first, count - size_, data_.GetAddress() + size_);
+            }
+            else
+            {
+                std::destroy_n(data_.GetAddress() + count, size_ - count);
+            }
+            size_ = count;
+        }
+        else
+        {
+            Vector tmp(GetAllocator());
+            for (; first != last; ++first)
+            {
+                tmp.EmplaceBack(*first);
+            }
+            SwapBuffers(tmp);
+        }
+    }
+
+    template <typename Range>
+    void AssignRange(const Range &range)
+    {
+        AssignRange(std::begin(range), std::end(range));
+    }
+
+    // Заменяет содержимое вектора копией rhs. При reuse_capacity элементы копируются в имеющийся
+    // буфер, если он вмещает rhs, и емкость никогда не уменьшается. Иначе вектор получает
+    // буфер ровно под rhs.Size() элементов, как при копирующем конструировании.
+    // Если буфер приходится заменять, старый освобождается до выделения нового при
+    // ReleaseBeforeCopyAssignV<T>. Тривиально копируемые элементы копируются одним memcpy
+    VECTOR_CONSTEXPR void Assign(const Vector &rhs, bool reuse_capacity)
+    {
+        if (this == &rhs)
+        {
+            return;
+        }
+        if constexpr (AllocTraits::propagate_on_container_copy_assignment::value &&
+                      !AllocTraits::is_always_equal::value)
+        {
+            if (GetAllocator() != rhs.GetAllocator())
+            {
+                // Наш буфер может освободить только наш аллокатор, поэтому копию строим
+                // аллокатором rhs и забираем её вместе с ним
+                ReplaceWithCopy(rhs, rhs.GetAllocator());
+                return;
+            }
+        }
+        if (rhs.size_ > data_.Capacity() || (!reuse_capacity && rhs.size_ != data_.Capacity()))
+        {
+            ReplaceWithCopy(rhs, GetAllocator());
+            return;
+        }
+        if constexpr (std::is_trivially_copyable_v<T>)
+        {
+            CopyElements(rhs.data_.GetAddress(), rhs.size_, data_.GetAddress());
+        }
+        else
+        {
+            // Копируем общую часть
+            const size_t min_size = std::min(size_, rhs.size_);
+            for (size_t i = 0; i < min_size; ++i)
+            {
+                data_[i] = rhs.data_[i];
+            }
+
+            if (rhs.size_ > size_)
+            {
+                // Если rhs больше - копируем оставшиеся элементы
+                detail::UninitializedCopyN(
+                    rhs.data_.GetAddress() + size_,
+                    rhs.size_ - size_,
+                    data_.GetAddress() + size_);
+            }
+            else
+            {
+                // Если rhs меньше - уничтожаем лишние элементы
+                std::destroy_n(
+                    data_.GetAddress() + rhs.size_,
+                    size_ - rhs.size_);
+            }
+        }
+        size_ = rhs.size_;
+    }
+
 private:
+    // Копирует n элементов в неинициализированную память to. Тривиально копируемые
+    // элементы — одним memcpy
+    static VECTOR_CONSTEXPR void CopyElements(const T *from, size_t n, T *to)
+    {
+        if constexpr (std::is_trivially_copyable_v<T>)
+        {
+            if (n != 0 && !detail::IsConstantEvaluated())
+            {
+                std::memcpy(static_cast<void *>(to), from, n * sizeof(T));
+                return;
+            }
+        }
+        detail::UninitializedCopyN(from, n, to);
+    }
+
+    // Заменяет буфер новым буфером аллокатора alloc с копией элементов rhs
+    VECTOR_CONSTEXPR void ReplaceWithCopy(const Vector &rhs, const Alloc &alloc)
+    {
+        if constexpr (ReleaseBeforeCopyAssignV<T>)
+        {
+            // Память нашего буфера освобождается нашим аллокатором до выделения нового
+            std::destroy_n(data_.GetAddress(), size_);
+            size_ = 0;
+            data_ = Memory(alloc);
+            Memory memory(rhs.size_, alloc);
+            CopyElements(rhs.data_.GetAddress(), rhs.size_, memory.GetAddress());
+            data_ = std::move(memory);
+        }
+        else
+        {
+            Memory memory(rhs.size_, alloc);
+            CopyElements(rhs.data_.GetAddress(), rhs.size_, memory.GetAddress());
+            std::destroy_n(data_.GetAddress(), size_);
+            data_ = std::move(memory);
+        }
+        size_ = rhs.size_;
+        InvalidateIterators();
+    }
+
+    // Берет во владение буфер memory, первые size элементов которого уже созданы
+    Vector(Memory &&memory, size_t size) noexcept
+        : data_(std::move(memory)), size_(size)
+    {
+        assert(size_ <= data_.Capacity());
+    }
+
+    // Вставляет count элементов, начиная с first, перед pos
+    template <typename ForwardIt>
+    iterator InsertRange(const_iterator pos, ForwardIt first, size_t count)
+    {
+        const size_t offset = Offset(pos);
+        if (count == 0)
+        {
+            return begin() + offset;
+        }
+        // Без этого GCC при -O3 допускает переполнение size_ + count, при котором проверка
+        // емкости ниже проходит, и предупреждает о записи за пределы буфера
+        VECTOR_ASSUME(size_ <= Capacity());
+        const size_t new_size = size_ + count;
+
+        if (new_size > Capacity())
+        {
+            const size_t new_capacity = std::max(new_size, NextCapacity());
+            if constexpr (IsTriviallyRelocatableV<T> && Memory::CAN_REALLOCATE)
+            {
+                // Буфер переезжает целиком, дальше вставляем как в буфер достаточной емкости.
+                // При исключении во время вставки элементы вектора останутся прежними
+                if (!data_.TryExpand(new_capacity))
+                {
+                    data_.Reallocate(new_capacity);
+                    RecordRelocation(size_);
+                    InvalidateIterators();
+                }
+            }
+            else if (!data_.TryExpand(new_capacity))
+            {
+                // Новые элементы создаем до переноса старых: при исключении вектор не изменится
+                Memory new_data(new_capacity, GetAllocator());
+                std::uninitialized_copy_n(first, count, new_data.GetAddress() + offset);
+                detail::RelocateAroundGap(data_.GetAddress(), size_, offset, count, new_data.GetAddress());
+                RecordRelocation(size_);
+                data_.Swap(new_data);
+                InvalidateIterators();
+                size_ = new_size;
+                return begin() + offset;
+            }
+        }
+
+        T *const insert_pos = data_.GetAddress() + offset;
+        T *const old_end = data_.GetAddress() + size_;
+        const size_t tail = size_ - offset;
+        if constexpr (IsTriviallyRelocatableV<T>)
+        {
+            // Сдвигаем хвост побайтово и создаем новые элементы в освободившемся промежутке
+            std::memmove(static_cast<void *>(insert_pos + count), static_cast<const void *>(insert_pos),
+                         tail * sizeof(T));
+            try
+            {
+                std::uninitialized_copy_n(first, count, insert_pos);
+            }
+            catch (...)
+            {
+                std::memmove(static_cast<void *>(insert_pos), static_cast<const void *>(insert_pos + count),
+                             tail * sizeof(T));
+                throw;
+            }
+            size_ = new_size;
+        }
+        else if (tail > count)
+        {
+            // Последние count элементов хвоста переезжают в неинициализированную память,
+            // остальные сдвигаются присваиванием
+            std::uninitialized_move_n(old_end - count, count, old_end);
+            size_ = new_size;
+            std::move_backward(insert_pos, old_end - count, old_end);
+            std::copy_n(first, count, insert_pos);
+        }
+        else
+        {
+            // Часть новых элементов попадает в неинициализированную память за концом вектора
+            ForwardIt mid = std::next(first, tail);
+            std::uninitialized_copy_n(mid, count - tail, old_end);
+            size_ += count - tail;
+            std::uninitialized_move_n(insert_pos, tail, insert_pos + count);
+            size_ = new_size;
+            std::copy_n(first, tail, insert_pos);
+        }
+        return begin() + offset;
+    }
+
+    // Добавление в конец на этапе компиляции: без расширения на месте и побайтового переноса
+    template <typename... Args>
+    VECTOR_CONSTEXPR T &ConstantEmplaceBack(Args &&...args)
+    {
+        if (size_ == Capacity())
+        {
+            Memory new_data(NextCapacity(), GetAllocator());
+            detail::ConstructAt(new_data + size_, std::forward<Args>(args)...);
+            detail::RelocateN(data_.GetAddress(), size_, new_data.GetAddress());
+            data_.Swap(new_data);
+            InvalidateIterators();
+        }
+        else
+        {
+            detail::ConstructAt(data_ + size_, std::forward<Args>(args)...);
+        }
+        return data_[size_++];
+    }
+
+    // Переносит элементы в новый буфер емкости new_capacity >= size_
+    VECTOR_CONSTEXPR void ChangeCapacity(size_t new_capacity)
+    {
+        assert(new_capacity >= size_ && new_capacity != 0);
+        if constexpr (IsTriviallyRelocatableV<T> && Memory::CAN_REALLOCATE)
+        {
+            data_.Reallocate(new_capacity);
+        }
+        else
+        {
+            Memory new_data(new_capacity, GetAllocator());
+            detail::RelocateN(data_.GetAddress(), size_, new_data.GetAddress());
+            data_.Swap(new_data);
+        }
+        RecordRelocation(size_);
+        InvalidateIterators();
+    }
+
+    // Сообщает политике статистики о переносе count элементов в новый буфер.
+    // Первое выделение памяти пустым вектором реаллокацией не считается
+    static VECTOR_CONSTEXPR void RecordRelocation(size_t count) noexcept
+    {
+        constexpr bool BY_COPY = !IsTriviallyRelocatableV<T> && !std::is_nothrow_move_constructible_v<T> &&
+                                 std::is_copy_constructible_v<T>;
+        if (count != 0)
+        {
+            Stats::OnReallocate(BY_COPY ? 0 : count, BY_COPY ? count : 0, count * sizeof(T));
+        }
+    }
+
+    // Емкость, до которой вырастет вектор при вставке в заполненный буфер
+    VECTOR_CONSTEXPR size_t NextCapacity() const noexcept
+    {
+        const size_t new_capacity = Growth::NextCapacity(Capacity(), sizeof(T));
+        assert(new_capacity > Capacity());
+        return new_capacity;
+    }
+
+    // Уничтожает count элементов начиная с data параллельно. Если потоки не удалось
+    // запустить, элементы уничтожаются в вызывающем потоке
+    static void Destroy(T *data, size_t count, ParallelTag tag) noexcept
+    {
+        if constexpr (!std::is_trivially_destructible_v<T>)
+        {
+            detail::ParallelFor(count, sizeof(T), tag, [data](size_t first, size_t last) noexcept
+                                { std::destroy(data + first, data + last); });
+        }
+    }
+
+    // Обменивается буферами вместе с аллокаторами
+    VECTOR_CONSTEXPR void SwapBuffers(Vector &other) noexcept
+    {
+        data_.Swap(other.data_);
+        std::swap(size_, other.size_);
+        InvalidateIterators();
+        other.InvalidateIterators();
+    }
+
+    // Сообщает политике Checks о нарушении условия. Без проверок условие проверяется assert
+    static VECTOR_CONSTEXPR void Check(bool condition, const char *message) noexcept(NOTHROW_CHECKS)
+    {
+        if constexpr (Checks::CHECK_BOUNDS)
+        {
+            if (VECTOR_UNLIKELY(!condition))
+            {
+                Checks::OnViolation(message);
+            }
+        }
+        else
+        {
+            assert(condition && message);
+            (void)condition;
+            (void)message;
+        }
+    }
+
+    // Итераторы, полученные до замены буфера, становятся недействительными
+    VECTOR_CONSTEXPR void InvalidateIterators() noexcept
+    {
+        this->NextGeneration();
+    }
+
+    template <typename It, typename Ptr>
+    VECTOR_CONSTEXPR It MakeIterator(Ptr ptr) const noexcept
+    {
+        if constexpr (Checks::TRACK_ITERATORS)
+        {
+            return It(ptr, this, this->Generation());
+        }
+        else
+        {
+            return ptr;
+        }
+    }
+
+    // Номер элемента, на который указывает итератор pos, pos <= end()
+    VECTOR_CONSTEXPR size_t Offset(const_iterator pos) const noexcept(NOTHROW_CHECKS && !Checks::TRACK_ITERATORS)
+    {
+        const size_t offset = static_cast<size_t>(pos - cbegin());
+        Check(offset <= size_, "Vector iterator out of range");
+        return offset;
+    }
+
+    // Проверяет, что итератор создан для текущего буфера и, если dereference, указывает на элемент
+    VECTOR_CONSTEXPR void CheckIterator(const T *ptr, size_t generation, bool dereference) const
+        noexcept(NOTHROW_CHECKS)
+    {
+        Check(generation == this->Generation(), "Vector iterator invalidated by buffer change");
+        const size_t offset = static_cast<size_t>(ptr - data_.GetAddress());
+        Check(dereference ? offset < size_ : offset <= size_, "Vector iterator out of range");
+    }
+
+    // Проверяет, что разность итераторов определена: оба относятся к текущему буферу вектора
+    VECTOR_CONSTEXPR void CheckIterators(const T *ptr, size_t generation, const Vector *other_owner,
+                                         size_t other_generation) const noexcept(NOTHROW_CHECKS)
+    {
+        Check(other_owner == this, "Vector iterators belong to different vectors");
+        CheckIterator(ptr, generation, false);
+        Check(other_generation == generation, "Vector iterator invalidated by buffer change");
+    }
+
     // private:
-    RawMemory<T> data_;
+    Memory data_;
     size_t size_ = 0;
-};
\ No newline at end of file
+};
+
+// Вектор, буфер которого выровнен по границе ALIGNMENT байт, например AlignedVector<float, 64>
+// начинается на границе кэш-линии
+template <typename T, size_t ALIGNMENT, typename Growth = DoublingGrowth>
+using AlignedVector = Vector<T, AlignedAllocator<T, ALIGNMENT>, Growth>;
\ No newline at end of file
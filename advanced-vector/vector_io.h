@@ -0,0 +1,255 @@
+#pragma once
+#include "vector.h"
+
+#include <cstdint>
+#include <istream>
+#include <limits>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+
+// Двоичная сериализация Vector. Формат потока:
+//     [SerializedVectorHeader][элементы]
+// Тривиально копируемые элементы записываются одним непрерывным блоком, остальные —
+// поэлементно через VectorCodec<T>. Числа записываются в порядке байтов платформы
+struct SerializedVectorHeader
+{
+    static constexpr uint32_t MAGIC = 0x43455641; // "AVEC"
+    static constexpr uint32_t VERSION = 1;
+
+    enum Encoding : uint32_t
+    {
+        RAW = 0,
+        CODEC = 1,
+    };
+
+    uint32_t magic = MAGIC;
+    uint32_t version = VERSION;
+    uint32_t encoding = RAW;
+    uint32_t element_size = 0;
+    uint64_t size = 0;
+};
+
+namespace io_detail
+{
+    // Размер блока, которым читаются тривиально копируемые элементы
+    inline constexpr size_t CHUNK_BYTES = 64 * 1024;
+
+    template <typename T>
+    inline constexpr bool IS_RAW = std::is_trivially_copyable_v<T>;
+
+    // Количество непрочитанных байт потока или -1, если поток не поддерживает позиционирование
+    inline std::streamoff RemainingBytes(std::istream &in)
+    {
+        const std::istream::pos_type position = in.tellg();
+        if (position == std::istream::pos_type(-1))
+        {
+            in.clear();
+            return -1;
+        }
+        in.seekg(0, std::ios::end);
+        const std::istream::pos_type end = in.tellg();
+        in.clear();
+        in.seekg(position);
+        return end == std::istream::pos_type(-1) ? -1 : std::streamoff(end - position);
+    }
+
+    // Сколько элементов, записанных побайтово по element_bytes байт, зарезервировать под size
+    // элементов из заголовка.
+    // Размеру из заголовка нельзя доверять: если поток позволяет узнать остаток, размер
+    // проверяется по нему, иначе память резервируется на один блок вперед и растет по мере чтения
+    inline size_t ReserveCount(std::istream &in, uint64_t size, size_t element_bytes)
+    {
+        const size_t chunk = std::max(size_t(1), CHUNK_BYTES / element_bytes);
+        if (size <= chunk)
+        {
+            return static_cast<size_t>(size);
+        }
+        const std::streamoff remaining = RemainingBytes(in);
+        if (remaining < 0)
+        {
+            return chunk;
+        }
+        if (static_cast<uint64_t>(remaining) / element_bytes < size)
+        {
+            throw std::runtime_error("Deserialize: unexpected end of stream");
+        }
+        return static_cast<size_t>(size);
+    }
+} // namespace io_detail
+
+// Поэлементный кодек: Write(out, value) записывает значение, Read(in) читает его.
+// Для собственных типов объявляется специализация. Тривиально копируемые значения внутри
+// других кодеков записываются побайтово
+template <typename T, typename = void>
+struct VectorCodec
+{
+    static_assert(std::is_trivially_copyable_v<T>, "VectorCodec<T> must be specialized for this type");
+
+    static void Write(std::ostream &out, const T &value)
+    {
+        out.write(reinterpret_cast<const char *>(&value), sizeof(T));
+    }
+
+    static T Read(std::istream &in)
+    {
+        T value;
+        if (!in.read(reinterpret_cast<char *>(&value), sizeof(T)))
+        {
+            throw std::runtime_error("Deserialize: unexpected end of stream");
+        }
+        return value;
+    }
+};
+
+template <typename Char, typename Traits, typename Alloc>
+struct VectorCodec<std::basic_string<Char, Traits, Alloc>>
+{
+    using String = std::basic_string<Char, Traits, Alloc>;
+
+    static void Write(std::ostream &out, const String &value)
+    {
+        VectorCodec<uint64_t>::Write(out, value.size());
+        out.write(reinterpret_cast<const char *>(value.data()), value.size() * sizeof(Char));
+    }
+
+    static String Read(std::istream &in)
+    {
+        const uint64_t length = VectorCodec<uint64_t>::Read(in);
+        String value;
+        if (length > value.max_size())
+        {
+            throw std::runtime_error("Deserialize: string is too long");
+        }
+        value.reserve(io_detail::ReserveCount(in, length, sizeof(Char)));
+        constexpr size_t CHUNK = io_detail::CHUNK_BYTES / sizeof(Char);
+        while (value.size() < length)
+        {
+            const size_t offset = value.size();
+            const size_t count = std::min(CHUNK, static_cast<size_t>(length) - offset);
+            value.resize(offset + count);
+            if (!in.read(reinterpret_cast<char *>(value.data() + offset), count * sizeof(Char)))
+            {
+                throw std::runtime_error("Deserialize: unexpected end of stream");
+            }
+        }
+        return value;
+    }
+};
+
+template <typename T, typename... Params>
+void Serialize(const Vector<T, Params...> &v, std::ostream &out);
+
+template <typename T, typename... Params>
+void Deserialize(std::istream &in, Vector<T, Params...> &v);
+
+// Вложенные векторы записываются вместе со своим заголовком
+template <typename T, typename... Params>
+struct VectorCodec<Vector<T, Params...>>
+{
+    static void Write(std::ostream &out, const Vector<T, Params...> &value)
+    {
+        Serialize(value, out);
+    }
+
+    static Vector<T, Params...> Read(std::istream &in)
+    {
+        Vector<T, Params...> value;
+        Deserialize(in, value);
+        return value;
+    }
+};
+
+template <typename T, typename... Params>
+void Serialize(const Vector<T, Params...> &v, std::ostream &out)
+{
+    SerializedVectorHeader header;
+    header.encoding = io_detail::IS_RAW<T> ? SerializedVectorHeader::RAW : SerializedVectorHeader::CODEC;
+    header.element_size = sizeof(T);
+    header.size = v.Size();
+    out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+
+    if constexpr (io_detail::IS_RAW<T>)
+    {
+        out.write(reinterpret_cast<const char *>(v.Data()), v.Size() * sizeof(T));
+    }
+    else
+    {
+        for (const T &value : v)
+        {
+            VectorCodec<T>::Write(out, value);
+        }
+    }
+    if (!out)
+    {
+        throw std::runtime_error("Serialize: write failed");
+    }
+}
+
+// Читает вектор из потока. Если поток позволяет проверить, что данных хватит, память
+// выделяется один раз по размеру из заголовка, иначе буфер растет по мере чтения. Элементы
+// читаются из потока блоками прямо в буфер вектора. Если поток поврежден или оборван,
+// выбрасывается std::runtime_error, а v остается прежним
+template <typename T, typename... Params>
+void Deserialize(std::istream &in, Vector<T, Params...> &v)
+{
+    SerializedVectorHeader header;
+    if (!in.read(reinterpret_cast<char *>(&header), sizeof(header)))
+    {
+        throw std::runtime_error("Deserialize: unexpected end of stream");
+    }
+    if (header.magic != SerializedVectorHeader::MAGIC || header.version != SerializedVectorHeader::VERSION)
+    {
+        throw std::runtime_error("Deserialize: unsupported format");
+    }
+    const uint32_t expected_encoding = io_detail::IS_RAW<T> ? SerializedVectorHeader::RAW : SerializedVectorHeader::CODEC;
+    if (header.encoding != expected_encoding || header.element_size != sizeof(T))
+    {
+        throw std::runtime_error("Deserialize: element type mismatch");
+    }
+
+    if (header.size > std::numeric_limits<size_t>::max() / sizeof(T))
+    {
+        throw std::runtime_error("Deserialize: vector is too long");
+    }
+    const size_t size = static_cast<size_t>(header.size);
+    constexpr size_t CHUNK = std::max(size_t(1), io_detail::CHUNK_BYTES / sizeof(T));
+    Vector<T, Params...> result(v.GetAllocator());
+    if constexpr (io_detail::IS_RAW<T>)
+    {
+        result.Reserve(io_detail::ReserveCount(in, size, sizeof(T)));
+        while (result.Size() < size)
+        {
+            const size_t offset = result.Size();
+            const size_t count = std::min(CHUNK, size - offset);
+            if (offset + count > result.Capacity())
+            {
+                // Остаток неизвестен: буфер растет геометрически, а не на блок за раз
+                result.Reserve(std::max(offset + count, std::min(size, 2 * result.Capacity())));
+            }
+            result.ResizeUninitialized(offset + count);
+            if (!in.read(reinterpret_cast<char *>(result.Data() + offset), count * sizeof(T)))
+            {
+                throw std::runtime_error("Deserialize: unexpected end of stream");
+            }
+        }
+    }
+    else
+    {
+        // Длина записи элемента заранее неизвестна, поэтому остаток потока не проверяется
+        result.Reserve(std::min(size, CHUNK));
+        for (size_t i = 0; i < size; ++i)
+        {
+            result.EmplaceBack(VectorCodec<T>::Read(in));
+        }
+    }
+    v = std::move(result);
+}
+
+template <typename T, typename Alloc = std::allocator<T>>
+Vector<T, Alloc> Deserialize(std::istream &in, const Alloc &alloc = Alloc())
+{
+    Vector<T, Alloc> v(alloc);
+    Deserialize(in, v);
+    return v;
+}
\ No newline at end of file
@@ -0,0 +1,482 @@
+#pragma once
+#include "vector.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <ostream>
+#include <string_view>
+#include <tuple>
+
+#if __cplusplus >= 202002L && defined(__has_include)
+#if __has_include(<source_location>)
+#include <source_location>
+#endif
+#endif
+
+#if defined(__cpp_lib_source_location)
+#define VECTOR_HAS_SOURCE_LOCATION 1
+#else
+#define VECTOR_HAS_SOURCE_LOCATION 0
+#endif
+
+// Место в исходном коде. Начиная с C++20 определяется через std::source_location, в C++17 —
+// через встроенные функции GCC и Clang; на других компиляторах место неизвестно.
+// Current() в аргументе по умолчанию возвращает место вызова функции с этим аргументом
+struct VectorSourceLocation
+{
+    const char *file = "unknown";
+    unsigned line = 0;
+    const char *function = "unknown";
+
+#if VECTOR_HAS_SOURCE_LOCATION
+    static constexpr VectorSourceLocation Current(
+        std::source_location location = std::source_location::current()) noexcept
+    {
+        return {location.file_name(), static_cast<unsigned>(location.line()), location.function_name()};
+    }
+#elif defined(__GNUC__)
+    static constexpr VectorSourceLocation Current(const char *file = __builtin_FILE(), unsigned line = __builtin_LINE(),
+                                                  const char *function = __builtin_FUNCTION()) noexcept
+    {
+        return {file, line, function};
+    }
+#else
+    static constexpr VectorSourceLocation Current() noexcept
+    {
+        return {};
+    }
+#endif
+};
+
+// Сводка по одному месту создания ProfiledVector (или вызова Reserve)
+struct VectorSiteProfile
+{
+    VectorSourceLocation location;
+    size_t live_instances = 0;
+    size_t constructed = 0;
+    size_t allocations = 0;
+    size_t allocated_bytes = 0;
+    size_t reallocations = 0;
+    size_t relocated_bytes = 0;
+    // Суммарный размер элементов и емкость буферов живых векторов
+    size_t live_size_bytes = 0;
+    size_t live_capacity_bytes = 0;
+    // Суммарные размер и емкость векторов на момент уничтожения
+    size_t final_size_sum = 0;
+    size_t final_capacity_sum = 0;
+
+    size_t SlackBytes() const noexcept
+    {
+        return live_capacity_bytes - live_size_bytes;
+    }
+
+    // Средний размер вектора при уничтожении
+    double AverageFinalSize() const noexcept
+    {
+        const size_t destroyed = constructed - live_instances;
+        return destroyed == 0 ? 0.0 : static_cast<double>(final_size_sum) / static_cast<double>(destroyed);
+    }
+};
+
+namespace profile_detail
+{
+    struct Tracker;
+
+    struct Site
+    {
+        VectorSourceLocation location;
+        std::atomic<size_t> constructed{0};
+        std::atomic<size_t> destroyed{0};
+        std::atomic<size_t> allocations{0};
+        std::atomic<size_t> allocated_bytes{0};
+        std::atomic<size_t> reallocations{0};
+        std::atomic<size_t> relocated_bytes{0};
+        std::atomic<size_t> final_size_sum{0};
+        std::atomic<size_t> final_capacity_sum{0};
+        // Список живых векторов, защищен мьютексом реестра
+        Tracker *live = nullptr;
+    };
+
+    // Запись живого вектора в списке места создания. measure добавляет к счетчикам
+    // размер элементов и емкость буфера вектора owner в байтах
+    struct Tracker
+    {
+        Site *site = nullptr;
+        Tracker *prev = nullptr;
+        Tracker *next = nullptr;
+        const void *owner = nullptr;
+        void (*measure)(const void *owner, size_t &size_bytes, size_t &capacity_bytes) noexcept = nullptr;
+    };
+
+    // Место, которому приписываются события памяти выполняемой в потоке операции
+    inline thread_local Site *current_site = nullptr;
+
+    class SiteScope
+    {
+    public:
+        explicit SiteScope(Site *site) noexcept
+            : previous_(current_site)
+        {
+            current_site = site;
+        }
+
+        SiteScope(const SiteScope &) = delete;
+        SiteScope &operator=(const SiteScope &) = delete;
+
+        ~SiteScope()
+        {
+            current_site = previous_;
+        }
+
+    private:
+        Site *previous_;
+    };
+
+    // Политика статистики ProfiledVector: события записываются в счетчики текущего места
+    struct SiteStats
+    {
+        static void OnAllocate(size_t bytes) noexcept
+        {
+            if (Site *site = current_site)
+            {
+                site->allocations.fetch_add(1, std::memory_order_relaxed);
+                site->allocated_bytes.fetch_add(bytes, std::memory_order_relaxed);
+            }
+        }
+
+        static void OnCapacity(size_t /*capacity*/) noexcept
+        {
+        }
+
+        static void OnReallocate(size_t /*moved*/, size_t /*copied*/, size_t bytes) noexcept
+        {
+            if (Site *site = current_site)
+            {
+                site->reallocations.fetch_add(1, std::memory_order_relaxed);
+                site->relocated_bytes.fetch_add(bytes, std::memory_order_relaxed);
+            }
+        }
+    };
+} // namespace profile_detail
+
+// Реестр мест создания ProfiledVector. Места хранятся до завершения программы, поэтому
+// отчет можно получить и при выходе, после уничтожения статических объектов.
+// Snapshot и Report читают размеры живых векторов: вызывать их следует, когда векторы
+// не изменяются в других потоках
+class VectorProfiler
+{
+public:
+    // Места, упорядоченные по убыванию relocated_bytes + SlackBytes(): сначала те, где
+    // больше всего байт перенесено при росте или простаивает в резерве
+    static Vector<VectorSiteProfile> Snapshot()
+    {
+        Registry &registry = GetRegistry();
+        Vector<VectorSiteProfile> profiles;
+        {
+            const std::lock_guard lock(registry.mutex);
+            profiles.Reserve(registry.sites.size());
+            for (const auto &[key, site] : registry.sites)
+            {
+                profiles.PushBack(MakeProfile(site));
+            }
+        }
+        std::sort(profiles.begin(), profiles.end(), [](const VectorSiteProfile &lhs, const VectorSiteProfile &rhs)
+                  { return lhs.relocated_bytes + lhs.SlackBytes() > rhs.relocated_bytes + rhs.SlackBytes(); });
+        return profiles;
+    }
+
+    // Выводит не больше limit первых мест Snapshot()
+    static void Report(std::ostream &out, size_t limit = 20)
+    {
+        const Vector<VectorSiteProfile> profiles = Snapshot();
+        out << "Vector profile: " << profiles.Size() << " sites, ranked by relocated + slack bytes\n";
+        for (size_t i = 0; i < profiles.Size() && i < limit; ++i)
+        {
+            const VectorSiteProfile &p = profiles[i];
+            out << p.location.file << ':' << p.location.line << " (" << p.location.function << "):"
+                << " relocated=" << p.relocated_bytes << "B reallocations=" << p.reallocations
+                << " slack=" << p.SlackBytes() << "B live=" << p.live_instances << '/' << p.constructed
+                << " allocations=" << p.allocations << " allocated=" << p.allocated_bytes << 'B'
+                << " avg_final_size=" << p.AverageFinalSize() << '\n';
+        }
+    }
+
+    // Выводит отчет в std::cerr при завершении программы
+    static void ReportAtExit(size_t limit = 20)
+    {
+        exit_report_limit_ = limit;
+        static const bool registered = std::atexit(&ReportToStderr) == 0;
+        (void)registered;
+    }
+
+private:
+    template <typename, typename, typename>
+    friend class ProfiledVector;
+
+    using Key = std::tuple<std::string_view, unsigned, std::string_view>;
+
+    struct Registry
+    {
+        std::mutex mutex;
+        std::map<Key, profile_detail::Site> sites;
+    };
+
+    // Реестр не уничтожается, чтобы его могли использовать статические объекты и отчет при выходе
+    static Registry &GetRegistry()
+    {
+        static Registry *const registry = new Registry;
+        return *registry;
+    }
+
+    static profile_detail::Site *GetSite(const VectorSourceLocation &location)
+    {
+        Registry &registry = GetRegistry();
+        const std::lock_guard lock(registry.mutex);
+        const auto [it, inserted] = registry.sites.try_emplace(Key(location.file, location.line, location.function));
+        if (inserted)
+        {
+            it->second.location = location;
+        }
+        return &it->second;
+    }
+
+    static void Register(profile_detail::Tracker &tracker) noexcept
+    {
+        Registry &registry = GetRegistry();
+        const std::lock_guard lock(registry.mutex);
+        profile_detail::Site &site = *tracker.site;
+        tracker.next = site.live;
+        if (site.live != nullptr)
+        {
+            site.live->prev = &tracker;
+        }
+        site.live = &tracker;
+        site.constructed.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    static void Unregister(profile_detail::Tracker &tracker, size_t final_size, size_t final_capacity) noexcept
+    {
+        Registry &registry = GetRegistry();
+        const std::lock_guard lock(registry.mutex);
+        profile_detail::Site &site = *tracker.site;
+        (tracker.prev != nullptr ? tracker.prev->next : site.live) = tracker.next;
+        if (tracker.next != nullptr)
+        {
+            tracker.next->prev = tracker.prev;
+        }
+        site.final_size_sum.fetch_add(final_size, std::memory_order_relaxed);
+        site.final_capacity_sum.fetch_add(final_capacity, std::memory_order_relaxed);
+        site.destroyed.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    static VectorSiteProfile MakeProfile(const profile_detail::Site &site) noexcept
+    {
+        VectorSiteProfile profile;
+        profile.location = site.location;
+        profile.constructed = site.constructed.load(std::memory_order_relaxed);
+        profile.live_instances = profile.constructed - site.destroyed.load(std::memory_order_relaxed);
+        profile.allocations = site.allocations.load(std::memory_order_relaxed);
+        profile.allocated_bytes = site.allocated_bytes.load(std::memory_order_relaxed);
+        profile.reallocations = site.reallocations.load(std::memory_order_relaxed);
+        profile.relocated_bytes = site.relocated_bytes.load(std::memory_order_relaxed);
+        profile.final_size_sum = site.final_size_sum.load(std::memory_order_relaxed);
+        profile.final_capacity_sum = site.final_capacity_sum.load(std::memory_order_relaxed);
+        for (const profile_detail::Tracker *tracker = site.live; tracker != nullptr; tracker = tracker->next)
+        {
+            tracker->measure(tracker->owner, profile.live_size_bytes, profile.live_capacity_bytes);
+        }
+        return profile;
+    }
+
+    static void ReportToStderr()
+    {
+        Report(std::cerr, exit_report_limit_);
+    }
+
+    static inline std::atomic<size_t> exit_report_limit_{20};
+};
+
+// Vector, который учитывается в VectorProfiler по месту создания. Выделения памяти
+// и переносы элементов при росте приписываются месту вызова конструктора, а выделения
+// внутри Reserve — месту вызова Reserve. Отчет показывает, где не хватает Reserve (много
+// реаллокаций и перенесенных байт), где резерв простаивает (slack) и где векторы остаются
+// маленькими (avg_final_size) и их стоит заменить на SmallVector.
+// Профилирование включается заменой типа в нужных местах; создание и уничтожение вектора
+// захватывают мьютекс реестра
+template <typename T, typename Alloc = std::allocator<T>, typename Growth = DoublingGrowth>
+class ProfiledVector : public Vector<T, Alloc, Growth, profile_detail::SiteStats>
+{
+    using Base = Vector<T, Alloc, Growth, profile_detail::SiteStats>;
+    using Location = VectorSourceLocation;
+    using SiteScope = profile_detail::SiteScope;
+
+public:
+    explicit ProfiledVector(Location location = Location::Current())
+    {
+        Track(location);
+    }
+
+    // Вектор регистрируется после заполнения: если конструктор выбросит исключение,
+    // в списке живых векторов не останется записи об уничтоженном объекте
+    explicit ProfiledVector(size_t size, Location location = Location::Current())
+    {
+        {
+            const SiteScope scope(tracker_.site = VectorProfiler::GetSite(location));
+            Base::Resize(size);
+        }
+        Register();
+    }
+
+    ProfiledVector(const ProfiledVector &other, Location location = Location::Current())
+        : Base()
+    {
+        {
+            const SiteScope scope(tracker_.site = VectorProfiler::GetSite(location));
+            Base::operator=(Base(other));
+        }
+        Register();
+    }
+
+    // Перемещенный вектор учитывается по месту создания исходного: место уже есть в реестре,
+    // и регистрация не выделяет память
+    ProfiledVector(ProfiledVector &&other) noexcept
+        : Base(std::move(other))
+    {
+        tracker_.site = other.tracker_.site;
+        Register();
+    }
+
+    ~ProfiledVector()
+    {
+        VectorProfiler::Unregister(tracker_, Base::Size(), Base::Capacity());
+    }
+
+    ProfiledVector &operator=(const ProfiledVector &rhs)
+    {
+        const SiteScope scope(tracker_.site);
+        Base::operator=(rhs);
+        return *this;
+    }
+
+    ProfiledVector &operator=(ProfiledVector &&rhs) noexcept
+    {
+        Base::operator=(std::move(rhs));
+        return *this;
+    }
+
+    void Reserve(size_t new_capacity, Location location = Location::Current())
+    {
+        if (new_capacity <= Base::Capacity())
+        {
+            return;
+        }
+        const SiteScope scope(VectorProfiler::GetSite(location));
+        Base::Reserve(new_capacity);
+    }
+
+    void Reserve(size_t new_capacity, ParallelTag tag, Location location = Location::Current())
+    {
+        if (new_capacity <= Base::Capacity())
+        {
+            return;
+        }
+        const SiteScope scope(VectorProfiler::GetSite(location));
+        Base::Reserve(new_capacity, tag);
+    }
+
+    void ShrinkToFit()
+    {
+        const SiteScope scope(tracker_.site);
+        Base::ShrinkToFit();
+    }
+
+    void Resize(size_t new_size)
+    {
+        const SiteScope scope(tracker_.site);
+        Base::Resize(new_size);
+    }
+
+    void ResizeUninitialized(size_t new_size)
+    {
+        const SiteScope scope(tracker_.site);
+        Base::ResizeUninitialized(new_size);
+    }
+
+    void PushBack(const T &value)
+    {
+        const SiteScope scope(tracker_.site);
+        Base::PushBack(value);
+    }
+    void PushBack(T &&value)
+    {
+        const SiteScope scope(tracker_.site);
+        Base::PushBack(std::move(value));
+    }
+
+    template <typename... Args>
+    T &EmplaceBack(Args &&...args)
+    {
+        const SiteScope scope(tracker_.site);
+        return Base::EmplaceBack(std::forward<Args>(args)...);
+    }
+
+    template <typename... Args>
+    auto Emplace(typename Base::const_iterator pos, Args &&...args)
+    {
+        const SiteScope scope(tracker_.site);
+        return Base::Emplace(pos, std::forward<Args>(args)...);
+    }
+
+    template <typename... Args>
+    auto Insert(typename Base::const_iterator pos, Args &&...args)
+    {
+        const SiteScope scope(tracker_.site);
+        return Base::Insert(pos, std::forward<Args>(args)...);
+    }
+
+    template <typename Range>
+    void Append(const Range &range)
+    {
+        const SiteScope scope(tracker_.site);
+        Base::Append(range);
+    }
+
+    template <typename... Args>
+    void AssignRange(Args &&...args)
+    {
+        const SiteScope scope(tracker_.site);
+        Base::AssignRange(std::forward<Args>(args)...);
+    }
+
+    void Assign(const ProfiledVector &rhs, bool reuse_capacity)
+    {
+        const SiteScope scope(tracker_.site);
+        Base::Assign(rhs, reuse_capacity);
+    }
+
+private:
+    void Track(const Location &location)
+    {
+        tracker_.site = VectorProfiler::GetSite(location);
+        Register();
+    }
+
+    void Register() noexcept
+    {
+        tracker_.owner = this;
+        tracker_.measure = &Measure;
+        VectorProfiler::Register(tracker_);
+    }
+
+    static void Measure(const void *owner, size_t &size_bytes, size_t &capacity_bytes) noexcept
+    {
+        const ProfiledVector &v = *static_cast<const ProfiledVector *>(owner);
+        size_bytes += v.Size() * sizeof(T);
+        capacity_bytes += v.Capacity() * sizeof(T);
+    }
+
+    profile_detail::Tracker tracker_;
+};
\ No newline at end of file
@@ -0,0 +1,754 @@
+#pragma once
+#include "vector.h"
+
+#include <cstdint>
+#include <utility>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define VECTOR_SIMD_X86 1
+#include <immintrin.h>
+#elif defined(__aarch64__)
+#define VECTOR_SIMD_NEON 1
+#include <arm_neon.h>
+#endif
+
+// Векторизованные операции над элементами Vector арифметических типов.
+// Для int32_t и float используются SSE2/AVX2 (выбор при первом вызове по возможностям
+// процессора) или NEON, для остальных типов — скалярные циклы, которые компилятор может
+// векторизовать сам. Функции пространства имен simd работают прямо с буфером вектора, без
+// промежуточных копий. Transform принимает произвольную операцию, поэтому его ядро —
+// цикл по блокам ширины регистра, который компилируется отдельно для каждого набора инструкций
+
+namespace simd_detail
+{
+    template <typename T>
+    inline constexpr bool HAS_KERNELS = std::is_same_v<T, int32_t> || std::is_same_v<T, float>;
+
+    template <typename T>
+    size_t CountScalar(const T *data, size_t size, T value) noexcept
+    {
+        size_t count = 0;
+        for (size_t i = 0; i < size; ++i)
+        {
+            count += data[i] == value ? 1 : 0;
+        }
+        return count;
+    }
+
+    template <typename T>
+    size_t FindScalar(const T *data, size_t size, T value) noexcept
+    {
+        for (size_t i = 0; i < size; ++i)
+        {
+            if (data[i] == value)
+            {
+                return i;
+            }
+        }
+        return size;
+    }
+
+    template <typename T>
+    T SumScalar(const T *data, size_t size) noexcept
+    {
+        if constexpr (std::is_integral_v<T>)
+        {
+            // Сложение в беззнаковом типе: переполнение заворачивается без неопределенного поведения
+            std::make_unsigned_t<T> sum = 0;
+            for (size_t i = 0; i < size; ++i)
+            {
+                sum += static_cast<std::make_unsigned_t<T>>(data[i]);
+            }
+            return static_cast<T>(sum);
+        }
+        else
+        {
+            T sum = T();
+            for (size_t i = 0; i < size; ++i)
+            {
+                sum += data[i];
+            }
+            return sum;
+        }
+    }
+
+    template <typename T>
+    void FillScalar(T *data, size_t size, T value) noexcept
+    {
+        for (size_t i = 0; i < size; ++i)
+        {
+            data[i] = value;
+        }
+    }
+
+    template <typename T, typename UnaryOp>
+    void TransformScalar(const T *in, T *out, size_t size, UnaryOp &op)
+    {
+        for (size_t i = 0; i < size; ++i)
+        {
+            out[i] = static_cast<T>(op(in[i]));
+        }
+    }
+
+    // Обрабатывает блоки по LANES элементов: блок читается целиком до записи, поэтому in и
+    // out могут совпадать, а цикл фиксированной длины компилятор превращает в одну операцию
+    // над регистром. Встраивается в ядра Sse2/Avx2 и компилируется с их набором инструкций
+    template <size_t LANES, typename T, typename UnaryOp>
+    __attribute__((always_inline)) inline void TransformBlocks(const T *in, T *out, size_t size, UnaryOp &op)
+    {
+        size_t i = 0;
+        for (; i + LANES <= size; i += LANES)
+        {
+            T lanes[LANES];
+            std::memcpy(lanes, in + i, sizeof(lanes));
+            for (size_t k = 0; k < LANES; ++k)
+            {
+                lanes[k] = static_cast<T>(op(lanes[k]));
+            }
+            std::memcpy(out + i, lanes, sizeof(lanes));
+        }
+        TransformScalar(in + i, out + i, size - i, op);
+    }
+
+    // Набор инструкций, которым выполняются ядра Transform
+    enum class Isa
+    {
+        SCALAR,
+        SSE2,
+        AVX2,
+        NEON,
+    };
+
+    template <typename T>
+    std::pair<T, T> MinMaxScalar(const T *data, size_t size, std::pair<T, T> init) noexcept
+    {
+        for (size_t i = 0; i < size; ++i)
+        {
+            init.first = data[i] < init.first ? data[i] : init.first;
+            init.second = init.second < data[i] ? data[i] : init.second;
+        }
+        return init;
+    }
+
+    // Набор реализаций операций для типа T
+    template <typename T>
+    struct Kernels
+    {
+        size_t (*count)(const T *data, size_t size, T value) noexcept;
+        size_t (*find)(const T *data, size_t size, T value) noexcept;
+        T (*sum)(const T *data, size_t size) noexcept;
+        std::pair<T, T> (*min_max)(const T *data, size_t size) noexcept;
+        void (*fill)(T *data, size_t size, T value) noexcept;
+        Isa isa;
+    };
+
+    template <typename T>
+    std::pair<T, T> MinMaxScalarKernel(const T *data, size_t size) noexcept
+    {
+        return MinMaxScalar(data + 1, size - 1, {data[0], data[0]});
+    }
+
+    template <typename T>
+    constexpr Kernels<T> SCALAR_KERNELS = {
+        &CountScalar<T>, &FindScalar<T>, &SumScalar<T>, &MinMaxScalarKernel<T>, &FillScalar<T>, Isa::SCALAR};
+
+#if defined(VECTOR_SIMD_X86)
+    // SSE2 есть на любом процессоре x86-64
+    struct Sse2
+    {
+        static size_t Count(const int32_t *data, size_t size, int32_t value) noexcept
+        {
+            const __m128i needle = _mm_set1_epi32(value);
+            size_t count = 0;
+            size_t i = 0;
+            for (; i + 4 <= size; i += 4)
+            {
+                const __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i));
+                count += __builtin_popcount(_mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(x, needle))));
+            }
+            return count + CountScalar(data + i, size - i, value);
+        }
+
+        static size_t Count(const float *data, size_t size, float value) noexcept
+        {
+            const __m128 needle = _mm_set1_ps(value);
+            size_t count = 0;
+            size_t i = 0;
+            for (; i + 4 <= size; i += 4)
+            {
+                count += __builtin_popcount(_mm_movemask_ps(_mm_cmpeq_ps(_mm_loadu_ps(data + i), needle)));
+            }
+            return count + CountScalar(data + i, size - i, value);
+        }
+
+        static size_t Find(const int32_t *data, size_t size, int32_t value) noexcept
+        {
+            const __m128i needle = _mm_set1_epi32(value);
+            size_t i = 0;
+            for (; i + 4 <= size; i += 4)
+            {
+                const __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i));
+                const int mask = _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(x, needle)));
+                if (mask != 0)
+                {
+                    return i + __builtin_ctz(mask);
+                }
+            }
+            return i + FindScalar(data + i, size - i, value);
+        }
+
+        static size_t Find(const float *data, size_t size, float value) noexcept
+        {
+            const __m128 needle = _mm_set1_ps(value);
+            size_t i = 0;
+            for (; i + 4 <= size; i += 4)
+            {
+                const int mask = _mm_movemask_ps(_mm_cmpeq_ps(_mm_loadu_ps(data + i), needle));
+                if (mask != 0)
+                {
+                    return i + __builtin_ctz(mask);
+                }
+            }
+            return i + FindScalar(data + i, size - i, value);
+        }
+
+        static int32_t Sum(const int32_t *data, size_t size) noexcept
+        {
+            __m128i acc = _mm_setzero_si128();
+            size_t i = 0;
+            for (; i + 4 <= size; i += 4)
+            {
+                acc = _mm_add_epi32(acc, _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i)));
+            }
+            alignas(16) int32_t lanes[4];
+            _mm_store_si128(reinterpret_cast<__m128i *>(lanes), acc);
+            const uint32_t sum = static_cast<uint32_t>(lanes[0]) + static_cast<uint32_t>(lanes[1]) +
+                                 static_cast<uint32_t>(lanes[2]) + static_cast<uint32_t>(lanes[3]) +
+                                 static_cast<uint32_t>(SumScalar(data + i, size - i));
+            return static_cast<int32_t>(sum);
+        }
+
+        static float Sum(const float *data, size_t size) noexcept
+        {
+            __m128 acc = _mm_setzero_ps();
+            size_t i = 0;
+            for (; i + 4 <= size; i += 4)
+            {
+                acc = _mm_add_ps(acc, _mm_loadu_ps(data + i));
+            }
+            alignas(16) float lanes[4];
+            _mm_store_ps(lanes, acc);
+            return (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]) + SumScalar(data + i, size - i);
+        }
+
+        static std::pair<float, float> MinMax(const float *data, size_t size) noexcept
+        {
+            if (size < 4)
+            {
+                return MinMaxScalarKernel(data, size);
+            }
+            __m128 min = _mm_loadu_ps(data);
+            __m128 max = min;
+            size_t i = 4;
+            for (; i + 4 <= size; i += 4)
+            {
+                const __m128 x = _mm_loadu_ps(data + i);
+                min = _mm_min_ps(min, x);
+                max = _mm_max_ps(max, x);
+            }
+            alignas(16) float mins[4];
+            alignas(16) float maxs[4];
+            _mm_store_ps(mins, min);
+            _mm_store_ps(maxs, max);
+            const std::pair<float, float> lanes = MinMaxScalar(mins + 1, 3, {mins[0], maxs[0]});
+            return MinMaxScalar(data + i, size - i, MinMaxScalar(maxs + 1, 3, lanes));
+        }
+
+        static void Fill(int32_t *data, size_t size, int32_t value) noexcept
+        {
+            const __m128i x = _mm_set1_epi32(value);
+            size_t i = 0;
+            for (; i + 4 <= size; i += 4)
+            {
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(data + i), x);
+            }
+            FillScalar(data + i, size - i, value);
+        }
+
+        static void Fill(float *data, size_t size, float value) noexcept
+        {
+            const __m128 x = _mm_set1_ps(value);
+            size_t i = 0;
+            for (; i + 4 <= size; i += 4)
+            {
+                _mm_storeu_ps(data + i, x);
+            }
+            FillScalar(data + i, size - i, value);
+        }
+
+        template <typename T, typename UnaryOp>
+        static void Transform(const T *in, T *out, size_t size, UnaryOp &op)
+        {
+            TransformBlocks<16 / sizeof(T)>(in, out, size, op);
+        }
+    };
+
+    // AVX2 включается для отдельных функций, поэтому заголовок собирается без -mavx2
+    struct Avx2
+    {
+        __attribute__((target("avx2"))) static size_t Count(const int32_t *data, size_t size, int32_t value) noexcept
+        {
+            const __m256i needle = _mm256_set1_epi32(value);
+            size_t count = 0;
+            size_t i = 0;
+            for (; i + 8 <= size; i += 8)
+            {
+                const __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + i));
+                count += __builtin_popcount(_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(x, needle))));
+            }
+            return count + CountScalar(data + i, size - i, value);
+        }
+
+        __attribute__((target("avx2"))) static size_t Count(const float *data, size_t size, float value) noexcept
+        {
+            const __m256 needle = _mm256_set1_ps(value);
+            size_t count = 0;
+            size_t i = 0;
+            for (; i + 8 <= size; i += 8)
+            {
+                const __m256 eq = _mm256_cmp_ps(_mm256_loadu_ps(data + i), needle, _CMP_EQ_OQ);
+                count += __builtin_popcount(_mm256_movemask_ps(eq));
+            }
+            return count + CountScalar(data + i, size - i, value);
+        }
+
+        __attribute__((target("avx2"))) static size_t Find(const int32_t *data, size_t size, int32_t value) noexcept
+        {
+            const __m256i needle = _mm256_set1_epi32(value);
+            size_t i = 0;
+            for (; i + 8 <= size; i += 8)
+            {
+                const __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + i));
+                const int mask = _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(x, needle)));
+                if (mask != 0)
+                {
+                    return i + __builtin_ctz(mask);
+                }
+            }
+            return i + FindScalar(data + i, size - i, value);
+        }
+
+        __attribute__((target("avx2"))) static size_t Find(const float *data, size_t size, float value) noexcept
+        {
+            const __m256 needle = _mm256_set1_ps(value);
+            size_t i = 0;
+            for (; i + 8 <= size; i += 8)
+            {
+                const int mask = _mm256_movemask_ps(_mm256_cmp_ps(_mm256_loadu_ps(data + i), needle, _CMP_EQ_OQ));
+                if (mask != 0)
+                {
+                    return i + __builtin_ctz(mask);
+                }
+            }
+            return i + FindScalar(data + i, size - i, value);
+        }
+
+        __attribute__((target("avx2"))) static int32_t Sum(const int32_t *data, size_t size) noexcept
+        {
+            __m256i acc = _mm256_setzero_si256();
+            size_t i = 0;
+            for (; i + 8 <= size; i += 8)
+            {
+                acc = _mm256_add_epi32(acc, _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + i)));
+            }
+            alignas(32) int32_t lanes[8];
+            _mm256_store_si256(reinterpret_cast<__m256i *>(lanes), acc);
+            uint32_t sum = static_cast<uint32_t>(SumScalar(data + i, size - i));
+            for (int32_t lane : lanes)
+            {
+                sum += static_cast<uint32_t>(lane);
+            }
+            return static_cast<int32_t>(sum);
+        }
+
+        __attribute__((target("avx2"))) static float Sum(const float *data, size_t size) noexcept
+        {
+            __m256 acc = _mm256_setzero_ps();
+            size_t i = 0;
+            for (; i + 8 <= size; i += 8)
+            {
+                acc = _mm256_add_ps(acc, _mm256_loadu_ps(data + i));
+            }
+            alignas(32) float lanes[8];
+            _mm256_store_ps(lanes, acc);
+            return ((lanes[0] + lanes[1]) + (lanes[2] + lanes[3])) + ((lanes[4] + lanes[5]) + (lanes[6] + lanes[7])) +
+                   SumScalar(data + i, size - i);
+        }
+
+        __attribute__((target("avx2"))) static std::pair<int32_t, int32_t> MinMax(const int32_t *data,
+                                                                                   size_t size) noexcept
+        {
+            if (size < 8)
+            {
+                return MinMaxScalarKernel(data, size);
+            }
+            __m256i min = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data));
+            __m256i max = min;
+            size_t i = 8;
+            for (; i + 8 <= size; i += 8)
+            {
+                const __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + i));
+                min = _mm256_min_epi32(min, x);
+                max = _mm256_max_epi32(max, x);
+            }
+            alignas(32) int32_t mins[8];
+            alignas(32) int32_t maxs[8];
+            _mm256_store_si256(reinterpret_cast<__m256i *>(mins), min);
+            _mm256_store_si256(reinterpret_cast<__m256i *>(maxs), max);
+            const std::pair<int32_t, int32_t> lanes = MinMaxScalar(mins + 1, 7, {mins[0], maxs[0]});
+            return MinMaxScalar(data + i, size - i, MinMaxScalar(maxs + 1, 7, lanes));
+        }
+
+        __attribute__((target("avx2"))) static std::pair<float, float> MinMax(const float *data, size_t size) noexcept
+        {
+            if (size < 8)
+            {
+                return MinMaxScalarKernel(data, size);
+            }
+            __m256 min = _mm256_loadu_ps(data);
+            __m256 max = min;
+            size_t i = 8;
+            for (; i + 8 <= size; i += 8)
+            {
+                const __m256 x = _mm256_loadu_ps(data + i);
+                min = _mm256_min_ps(min, x);
+                max = _mm256_max_ps(max, x);
+            }
+            alignas(32) float mins[8];
+            alignas(32) float maxs[8];
+            _mm256_store_ps(mins, min);
+            _mm256_store_ps(maxs, max);
+            const std::pair<float, float> lanes = MinMaxScalar(mins + 1, 7, {mins[0], maxs[0]});
+            return MinMaxScalar(data + i, size - i, MinMaxScalar(maxs + 1, 7, lanes));
+        }
+
+        __attribute__((target("avx2"))) static void Fill(int32_t *data, size_t size, int32_t value) noexcept
+        {
+            const __m256i x = _mm256_set1_epi32(value);
+            size_t i = 0;
+            for (; i + 8 <= size; i += 8)
+            {
+                _mm256_storeu_si256(reinterpret_cast<__m256i *>(data + i), x);
+            }
+            FillScalar(data + i, size - i, value);
+        }
+
+        __attribute__((target("avx2"))) static void Fill(float *data, size_t size, float value) noexcept
+        {
+            const __m256 x = _mm256_set1_ps(value);
+            size_t i = 0;
+            for (; i + 8 <= size; i += 8)
+            {
+                _mm256_storeu_ps(data + i, x);
+            }
+            FillScalar(data + i, size - i, value);
+        }
+
+        template <typename T, typename UnaryOp>
+        __attribute__((target("avx2"))) static void Transform(const T *in, T *out, size_t size, UnaryOp &op)
+        {
+            TransformBlocks<32 / sizeof(T)>(in, out, size, op);
+        }
+    };
+
+    template <typename T>
+    Kernels<T> SelectKernels() noexcept
+    {
+        if (__builtin_cpu_supports("avx2"))
+        {
+            return {&Avx2::Count, &Avx2::Find, &Avx2::Sum, &Avx2::MinMax, &Avx2::Fill, Isa::AVX2};
+        }
+        if constexpr (std::is_same_v<T, float>)
+        {
+            return {&Sse2::Count, &Sse2::Find, &Sse2::Sum, &Sse2::MinMax, &Sse2::Fill, Isa::SSE2};
+        }
+        else
+        {
+            // В SSE2 нет сравнения min/max для int32_t
+            return {&Sse2::Count, &Sse2::Find, &Sse2::Sum, &MinMaxScalarKernel<T>, &Sse2::Fill, Isa::SSE2};
+        }
+    }
+#elif defined(VECTOR_SIMD_NEON)
+    // NEON есть на любом процессоре AArch64, выбор во время выполнения не нужен
+    struct Neon
+    {
+        static size_t Count(const int32_t *data, size_t size, int32_t value) noexcept
+        {
+            const int32x4_t needle = vdupq_n_s32(value);
+            size_t count = 0;
+            size_t i = 0;
+            for (; i + 4 <= size; i += 4)
+            {
+                count += vaddvq_u32(vshrq_n_u32(vceqq_s32(vld1q_s32(data + i), needle), 31));
+            }
+            return count + CountScalar(data + i, size - i, value);
+        }
+
+        static size_t Count(const float *data, size_t size, float value) noexcept
+        {
+            const float32x4_t needle = vdupq_n_f32(value);
+            size_t count = 0;
+            size_t i = 0;
+            for (; i + 4 <= size; i += 4)
+            {
+                count += vaddvq_u32(vshrq_n_u32(vceqq_f32(vld1q_f32(data + i), needle), 31));
+            }
+            return count + CountScalar(data + i, size - i, value);
+        }
+
+        static size_t Find(const int32_t *data, size_t size, int32_t value) noexcept
+        {
+            const int32x4_t needle = vdupq_n_s32(value);
+            size_t i = 0;
+            for (; i + 4 <= size; i += 4)
+            {
+                if (vmaxvq_u32(vceqq_s32(vld1q_s32(data + i), needle)) != 0)
+                {
+                    break;
+                }
+            }
+            return i + FindScalar(data + i, size - i, value);
+        }
+
+        static size_t Find(const float *data, size_t size, float value) noexcept
+        {
+            const float32x4_t needle = vdupq_n_f32(value);
+            size_t i = 0;
+            for (; i + 4 <= size; i += 4)
+            {
+                if (vmaxvq_u32(vceqq_f32(vld1q_f32(data + i), needle)) != 0)
+                {
+                    break;
+                }
+            }
+            return i + FindScalar(data + i, size - i, value);
+        }
+
+        static int32_t Sum(const int32_t *data, size_t size) noexcept
+        {
+            uint32x4_t acc = vdupq_n_u32(0);
+            size_t i = 0;
+            for (; i + 4 <= size; i += 4)
+            {
+                acc = vaddq_u32(acc, vreinterpretq_u32_s32(vld1q_s32(data + i)));
+            }
+            return static_cast<int32_t>(vaddvq_u32(acc) + static_cast<uint32_t>(SumScalar(data + i, size - i)));
+        }
+
+        static float Sum(const float *data, size_t size) noexcept
+        {
+            float32x4_t acc = vdupq_n_f32(0.0f);
+            size_t i = 0;
+            for (; i + 4 <= size; i += 4)
+            {
+                acc = vaddq_f32(acc, vld1q_f32(data + i));
+            }
+            return vaddvq_f32(acc) + SumScalar(data + i, size - i);
+        }
+
+        static std::pair<int32_t, int32_t> MinMax(const int32_t *data, size_t size) noexcept
+        {
+            if (size < 4)
+            {
+                return MinMaxScalarKernel(data, size);
+            }
+            int32x4_t min = vld1q_s32(data);
+            int32x4_t max = min;
+            size_t i = 4;
+            for (; i + 4 <= size; i += 4)
+            {
+                const int32x4_t x = vld1q_s32(data + i);
+                min = vminq_s32(min, x);
+                max = vmaxq_s32(max, x);
+            }
+            return MinMaxScalar(data + i, size - i, {vminvq_s32(min), vmaxvq_s32(max)});
+        }
+
+        static std::pair<float, float> MinMax(const float *data, size_t size) noexcept
+        {
+            if (size < 4)
+            {
+                return MinMaxScalarKernel(data, size);
+            }
+            float32x4_t min = vld1q_f32(data);
+            float32x4_t max = min;
+            size_t i = 4;
+            for (; i + 4 <= size; i += 4)
+            {
+                const float32x4_t x = vld1q_f32(data + i);
+                min = vminq_f32(min, x);
+                max = vmaxq_f32(max, x);
+            }
+            return MinMaxScalar(data + i, size - i, {vminvq_f32(min), vmaxvq_f32(max)});
+        }
+
+        static void Fill(int32_t *data, size_t size, int32_t value) noexcept
+        {
+            const int32x4_t x = vdupq_n_s32(value);
+            size_t i = 0;
+            for (; i + 4 <= size; i += 4)
+            {
+                vst1q_s32(data + i, x);
+            }
+            FillScalar(data + i, size - i, value);
+        }
+
+        static void Fill(float *data, size_t size, float value) noexcept
+        {
+            const float32x4_t x = vdupq_n_f32(value);
+            size_t i = 0;
+            for (; i + 4 <= size; i += 4)
+            {
+                vst1q_f32(data + i, x);
+            }
+            FillScalar(data + i, size - i, value);
+        }
+
+        template <typename T, typename UnaryOp>
+        static void Transform(const T *in, T *out, size_t size, UnaryOp &op)
+        {
+            TransformBlocks<16 / sizeof(T)>(in, out, size, op);
+        }
+    };
+
+    template <typename T>
+    Kernels<T> SelectKernels() noexcept
+    {
+        return {&Neon::Count, &Neon::Find, &Neon::Sum, &Neon::MinMax, &Neon::Fill, Isa::NEON};
+    }
+#else
+    template <typename T>
+    Kernels<T> SelectKernels() noexcept
+    {
+        return SCALAR_KERNELS<T>;
+    }
+#endif
+
+    // Реализации для T выбираются один раз, при первом обращении
+    template <typename T>
+    const Kernels<T> &GetKernels() noexcept
+    {
+        if constexpr (HAS_KERNELS<T>)
+        {
+            static const Kernels<T> kernels = SelectKernels<T>();
+            return kernels;
+        }
+        else
+        {
+            return SCALAR_KERNELS<T>;
+        }
+    }
+
+    // Ядро Transform для набора инструкций, выбранного GetKernels
+    template <typename T, typename UnaryOp>
+    void TransformKernel(const T *in, T *out, size_t size, UnaryOp &op)
+    {
+        switch (GetKernels<T>().isa)
+        {
+#if defined(VECTOR_SIMD_X86)
+        case Isa::AVX2:
+            Avx2::Transform(in, out, size, op);
+            return;
+        case Isa::SSE2:
+            Sse2::Transform(in, out, size, op);
+            return;
+#elif defined(VECTOR_SIMD_NEON)
+        case Isa::NEON:
+            Neon::Transform(in, out, size, op);
+            return;
+#endif
+        default:
+            TransformScalar(in, out, size, op);
+        }
+    }
+} // namespace simd_detail
+
+namespace simd
+{
+    // Присваивает value всем элементам вектора
+    template <typename T, typename... Params>
+    void Fill(Vector<T, Params...> &v, const T &value) noexcept
+    {
+        static_assert(std::is_arithmetic_v<T> && !std::is_same_v<T, bool>);
+        simd_detail::GetKernels<T>().fill(v.Data(), v.Size(), value);
+    }
+
+    // Записывает в dst результаты op для каждого элемента src, изменяя размер dst.
+    // src и dst могут быть одним и тем же вектором
+    template <typename T, typename... SrcParams, typename... DstParams, typename UnaryOp>
+    void Transform(const Vector<T, SrcParams...> &src, Vector<T, DstParams...> &dst, UnaryOp op)
+    {
+        static_assert(std::is_arithmetic_v<T> && !std::is_same_v<T, bool>);
+        if (static_cast<const void *>(&src) != static_cast<const void *>(&dst))
+        {
+            dst.ResizeUninitialized(src.Size());
+        }
+        simd_detail::TransformKernel(src.Data(), dst.Data(), src.Size(), op);
+    }
+
+    // Возвращает количество элементов, равных value
+    template <typename T, typename... Params>
+    size_t Count(const Vector<T, Params...> &v, const T &value) noexcept
+    {
+        static_assert(std::is_arithmetic_v<T> && !std::is_same_v<T, bool>);
+        return simd_detail::GetKernels<T>().count(v.Data(), v.Size(), value);
+    }
+
+    // Возвращает итератор на первый элемент, равный value, или end()
+    template <typename T, typename... Params>
+    typename Vector<T, Params...>::const_iterator Find(const Vector<T, Params...> &v, const T &value) noexcept
+    {
+        static_assert(std::is_arithmetic_v<T> && !std::is_same_v<T, bool>);
+        return v.begin() + simd_detail::GetKernels<T>().find(v.Data(), v.Size(), value);
+    }
+
+    // Возвращает сумму элементов. Целые складываются с заворачиванием при переполнении.
+    // Порядок сложения чисел с плавающей точкой отличается от последовательного, поэтому
+    // результат может отличаться от него в пределах погрешности округления
+    template <typename T, typename... Params>
+    T Sum(const Vector<T, Params...> &v) noexcept
+    {
+        static_assert(std::is_arithmetic_v<T> && !std::is_same_v<T, bool>);
+        return simd_detail::GetKernels<T>().sum(v.Data(), v.Size());
+    }
+
+    // Возвращает наименьший и наибольший элементы непустого вектора.
+    // Результат для векторов, содержащих NaN, не определен
+    template <typename T, typename... Params>
+    std::pair<T, T> MinMax(const Vector<T, Params...> &v) noexcept
+    {
+        static_assert(std::is_arithmetic_v<T> && !std::is_same_v<T, bool>);
+        assert(v.Size() > 0);
+        return simd_detail::GetKernels<T>().min_max(v.Data(), v.Size());
+    }
+
+    // Поэлементно сравнивает векторы. Целые сравниваются через memcmp; числа с плавающей точкой
+    // сравниваются по значению, чтобы NaN != NaN и 0.0 == -0.0
+    template <typename T, typename... LhsParams, typename... RhsParams>
+    bool Equal(const Vector<T, LhsParams...> &lhs, const Vector<T, RhsParams...> &rhs) noexcept
+    {
+        static_assert(std::is_arithmetic_v<T> && !std::is_same_v<T, bool>);
+        if (lhs.Size() != rhs.Size())
+        {
+            return false;
+        }
+        if constexpr (std::is_integral_v<T>)
+        {
+            return lhs.Size() == 0 || std::memcmp(lhs.Data(), rhs.Data(), lhs.Size() * sizeof(T)) == 0;
+        }
+        else
+        {
+            return std::equal(lhs.begin(), lhs.end(), rhs.begin());
+        }
+    }
+} // namespace simd
\ No newline at end of file